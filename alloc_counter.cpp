@@ -0,0 +1,47 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - counting heap allocations
+    Version: 1.0
+
+    Linking this file in replaces the global operator new, so every allocation
+    made with new (the arenas included) is counted.
+*/
+
+#include <stdlib.h>
+#include <new>
+#include "alloc_counter.h"
+
+static thread_local long long allocations = 0;
+
+long long heapAllocations() {
+    return allocations;
+}
+
+void* operator new(size_t size) {
+    allocations++;
+    void* memory = malloc(size > 0 ? size : 1);
+    if (memory == NULL) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* memory) noexcept {
+    free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept {
+    free(memory);
+}
@@ -0,0 +1,13 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - counting heap allocations
+    Version: 1.0
+*/
+
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+// Number of times operator new was called by the current thread
+long long heapAllocations();
+
+#endif
@@ -0,0 +1,48 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - memory arena
+    Version: 1.0
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "arena.h"
+
+// Function to get how much of the arena a block of the given size takes
+size_t arenaSpace(size_t bytes) {
+    return (bytes + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT;
+}
+
+// Function to get the memory for the arena, the only allocation it ever makes
+void initArena(Arena* arena, size_t size) {
+    arena->size = arenaSpace(size);
+    arena->used = 0;
+    arena->block = new char[arena->size + ARENA_ALIGNMENT];
+    size_t misalignment = size_t(arena->block) % ARENA_ALIGNMENT;
+    arena->memory = arena->block + (misalignment == 0 ? 0 : ARENA_ALIGNMENT - misalignment);
+}
+
+// Function to take the next block out of the arena
+void* arenaAlloc(Arena* arena, size_t bytes) {
+    size_t space = arenaSpace(bytes);
+    if (arena->used + space > arena->size) { // the arena is always made big enough, so this is a bug
+        printf("Error: the arena is too small (%zu of %zu bytes used, %zu more needed)!\n", arena->used, arena->size, space);
+        abort();
+    }
+    void* block = arena->memory + arena->used;
+    arena->used += space;
+    return block;
+}
+
+// Function to give back every block at once
+void resetArena(Arena* arena) {
+    arena->used = 0;
+}
+
+void freeArena(Arena* arena) {
+    delete[] arena->block;
+    arena->block = NULL;
+    arena->memory = NULL;
+    arena->size = 0;
+    arena->used = 0;
+}
@@ -0,0 +1,27 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - memory arena
+    Version: 1.0
+*/
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+#define ARENA_ALIGNMENT 64 // EVERY BLOCK STARTS ON ITS OWN CACHE LINE
+
+struct Arena { // One block of memory that is handed out piece by piece and given back all at once
+    char* block; // What new[] gave, kept to free it
+    char* memory; // The aligned start of the block
+    size_t size;
+    size_t used;
+};
+
+size_t arenaSpace(size_t bytes);
+void initArena(Arena* arena, size_t size);
+void* arenaAlloc(Arena* arena, size_t bytes);
+void resetArena(Arena* arena);
+void freeArena(Arena* arena);
+
+#endif
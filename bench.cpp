@@ -0,0 +1,465 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - benchmarks
+    Version: 1.0
+
+    Measures the routines that run in every step of the game on boards of
+    different sizes, with different numbers of roads and of cars on every
+    road. Every result is one line of CSV:
+        benchmark,rows,cols,roads,cars_per_road,ns_per_op,allocs_per_op,ops
+    Usage:
+        frog-bench [--sizes RxC,RxC,...] [--roads N,N,...] [--cars N,N,...] [--min-time SECONDS] [--only NAME]
+    Roads 0 means a random number of roads, like in the game. The render
+    benchmarks draw on a 40x200 screen and the view follows the frog like in
+    the game: render_null only works out what changed, render_ansi writes the
+    escape sequences to /dev/null and render_curses draws into a curses
+    terminal that writes to /dev/null (only built when curses is found).
+*/
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "alloc_counter.h"
+#include "engine.h"
+#include "render.h"
+#include "rewind.h"
+#include "solver.h"
+#ifdef BENCH_CURSES
+#include <curses.h>
+#endif
+
+//**********************
+//* DEFINING CONSTANTS *
+//**********************
+
+#define DEFAULT_SIZES "26x50,200x800,1000x1000,10000x10000" // FROM A TERMINAL TO A HUGE BOARD
+#define DEFAULT_ROADS "0"
+#define DEFAULT_CARS "1"
+#define DEFAULT_MIN_TIME 0.2 // SECONDS THAT EVERY BENCHMARK RUNS FOR AT LEAST
+#define MAX_CASES 32
+#define RENDER_LINES 40 // THE TERMINAL OF THE RENDER BENCHMARKS
+#define RENDER_COLUMNS 200
+#define BENCH_SEED 1
+#define BENCH_FROG_SPEED 3
+
+//***********************
+//* DEFINING STRUCTURES *
+//***********************
+
+struct BenchState { // A board with a frog and a stork, made once for every size
+    Board board;
+    Object frog;
+    Stork stork;
+    Timer timer;
+    long long tick;
+    double now;
+    int roads; // What was asked for, 0 for random
+    int cars_per_road;
+};
+
+// Runs the routine the given number of times, returns the nanoseconds that the routine itself took
+typedef double (*BenchFunction)(BenchState* state, long long iterations);
+
+struct Benchmark {
+    const char* name;
+    BenchFunction function;
+    int ops_per_iteration; // 0 for one op for every road
+};
+
+//*******************
+//* TIMER FUNCTIONS *
+//*******************
+
+double nanoseconds() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+//*******************
+//* BOARD FUNCTIONS *
+//*******************
+
+// Function to make a new level on the board, the frog and the stork go back to the start
+void resetState(BenchState* state) {
+    Board* board = &state->board;
+    seedRandom(board, BENCH_SEED);
+    initBoard(board, board->rows, board->cols, 1, 5, DEFAULT_TICK_RATE, state->tick, state->roads, state->cars_per_road, BENCH_FROG_SPEED);
+    initObject(&state->frog, board->rows - 1, board->cols / 2, 'O', BENCH_FROG_SPEED, state->now);
+    initStork(&state->stork, board, &state->frog, state->now);
+}
+
+void initState(BenchState* state, int rows, int cols, int roads, int cars_per_road) {
+    initArena(&state->board.arena, boardMemorySize(rows, cols, cars_per_road));
+    state->board.rows = rows;
+    state->board.cols = cols;
+    state->roads = roads;
+    state->cars_per_road = cars_per_road;
+    state->tick = 0;
+    state->now = 0.0;
+    initTimer(&state->timer, state->now);
+    resetState(state);
+}
+
+void freeState(BenchState* state) {
+    freeArena(&state->board.arena);
+}
+
+//**************
+//* BENCHMARKS *
+//**************
+
+double benchInitBoard(BenchState* state, long long iterations) {
+    Board* board = &state->board;
+    double start = nanoseconds();
+    for (long long i = 0; i < iterations; i++) {
+        initBoard(board, board->rows, board->cols, 1, 5, DEFAULT_TICK_RATE, state->tick, state->roads, state->cars_per_road, BENCH_FROG_SPEED);
+    }
+    double time = nanoseconds() - start;
+    resetState(state);
+    return time;
+}
+
+// Finding the rows of all the roads again, like initRoads does
+double benchFindRow(BenchState* state, long long iterations) {
+    Board* board = &state->board;
+    double start = nanoseconds();
+    for (long long i = 0; i < iterations; i++) {
+        for (int x = 1; x < board->rows - 1; x++) {
+            setBit(board->free_rows, x);
+        }
+        for (int j = 0; j < board->num_roads; j++) {
+            findRow(board, j);
+            clearBit(board->free_rows, board->roads[j].x);
+        }
+    }
+    double time = nanoseconds() - start;
+    resetState(state); // the roads don't match the cars anymore
+    return time;
+}
+
+// Checking if the level can be won, the level stays the same so every check does the same work
+double benchLevelSolvable(BenchState* state, long long iterations) {
+    int solvable = 0;
+    double start = nanoseconds();
+    for (long long i = 0; i < iterations; i++) {
+        solvable += levelSolvable(&state->board, BENCH_FROG_SPEED, state->tick);
+    }
+    double time = nanoseconds() - start;
+    if (solvable < 0) { // never true, only keeps the results used
+        printf("%d\n", solvable);
+    }
+    return time;
+}
+
+double benchUpdateCars(BenchState* state, long long iterations) {
+    state->frog.x = state->board.rows - 1; // on the start row, so the stopping cars don't wait for it
+    double start = nanoseconds();
+    for (long long i = 0; i < iterations; i++) {
+        state->tick++;
+        updateCars(&state->board, &state->frog, state->tick);
+    }
+    return nanoseconds() - start;
+}
+
+// Checking the cells of the whole board one after another
+double benchCheckCollision(BenchState* state, long long iterations) {
+    Object* frog = &state->frog;
+    int cells = state->board.rows * (state->board.cols - 1);
+    int hits = 0;
+    int cell = 0;
+    double start = nanoseconds();
+    for (long long i = 0; i < iterations; i++) {
+        frog->x = cell / (state->board.cols - 1);
+        frog->y = cell % (state->board.cols - 1);
+        hits += checkCollision(frog, &state->board);
+        cell = cell + 1 == cells ? 0 : cell + 1;
+    }
+    double time = nanoseconds() - start;
+    frog->x = state->board.rows - 1;
+    frog->y = state->board.cols / 2;
+    frog->on_friendly_car = false;
+    if (hits < 0) { // never true, only keeps the results used
+        printf("%d\n", hits);
+    }
+    return time;
+}
+
+// Moving the frog left and right, every move waits long enough to be allowed
+double benchMoveObject(BenchState* state, long long iterations) {
+    double start = nanoseconds();
+    for (long long i = 0; i < iterations; i++) {
+        state->now += 1.0;
+        moveObject(&state->frog, (i & 1) ? INPUT_LEFT : INPUT_RIGHT, &state->board, state->now);
+    }
+    return nanoseconds() - start;
+}
+
+// The stork flies towards the frog in the far corner and starts again when it gets there
+double benchUpdateStork(BenchState* state, long long iterations) {
+    Board* board = &state->board;
+    Stork* stork = &state->stork;
+    Object* frog = &state->frog;
+    frog->x = 0;
+    frog->y = board->cols - 2;
+    double time = 0.0;
+    double start = nanoseconds();
+    for (long long i = 0; i < iterations; i++) {
+        state->now += 1.0;
+        updateStork(stork, frog, board, state->now);
+        if (stork->x == frog->x && stork->y == frog->y) {
+            time += nanoseconds() - start;
+            moveStork(board, stork, board->rows - 1, 0);
+            start = nanoseconds();
+        }
+    }
+    time += nanoseconds() - start;
+    frog->x = board->rows - 1;
+    frog->y = board->cols / 2;
+    return time;
+}
+
+// Saving the state after every step of the cars, like the game does for the rewind
+double benchSaveSnapshot(BenchState* state, long long iterations) {
+    Game game;
+    game.board = &state->board;
+    game.frog = &state->frog;
+    game.stork = &state->stork;
+    game.timer = &state->timer;
+    game.status = GAME_RUNNING;
+    game.recording = NULL;
+    RewindBuffer rewind;
+    initRewind(&rewind, REWIND_MEMORY, REWIND_MAX_SNAPSHOTS);
+    double time = 0.0;
+    for (long long i = 0; i < iterations; i++) {
+        state->tick++;
+        updateCars(&state->board, &state->frog, state->tick);
+        game.tick = state->tick;
+        game.now = double(state->tick) / DEFAULT_TICK_RATE;
+        double start = nanoseconds();
+        saveSnapshot(&rewind, &game);
+        time += nanoseconds() - start;
+    }
+    freeRewind(&rewind);
+    return time;
+}
+
+// Drawing one frame after every step of the cars, like the game does, the frog walks up and down so the view moves
+double benchRenderWith(BenchState* state, long long iterations, RenderBackend* backend) {
+    Board* board = &state->board;
+    Renderer renderer;
+    initRenderer(&renderer, backend);
+    printEverything(&renderer, board, &state->frog, &state->stork, &state->timer); // the first frame draws everything
+    showFrame(&renderer);
+    double time = 0.0;
+    for (long long i = 0; i < iterations; i++) {
+        state->tick++;
+        updateCars(board, &state->frog, state->tick);
+        state->frog.x = board->rows - 1 - (int)(i % board->rows);
+        double start = nanoseconds();
+        printEverything(&renderer, board, &state->frog, &state->stork, &state->timer);
+        showFrame(&renderer);
+        time += nanoseconds() - start;
+    }
+    freeRenderer(&renderer);
+    return time;
+}
+
+double benchRenderNull(BenchState* state, long long iterations) {
+    RenderBackend backend;
+    initNullBackend(&backend, RENDER_LINES, RENDER_COLUMNS);
+    double time = benchRenderWith(state, iterations, &backend);
+    freeBackend(&backend);
+    return time;
+}
+
+double benchRenderAnsi(BenchState* state, long long iterations) {
+    int fd = open("/dev/null", O_WRONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    char lines[16];
+    char columns[16];
+    snprintf(lines, sizeof(lines), "%d", RENDER_LINES);
+    snprintf(columns, sizeof(columns), "%d", RENDER_COLUMNS);
+    setenv("LINES", lines, 1); // /dev/null isn't a terminal, so it has no size of its own
+    setenv("COLUMNS", columns, 1);
+    RenderBackend backend;
+    initAnsiBackend(&backend, fd);
+    double time = benchRenderWith(state, iterations, &backend);
+    freeBackend(&backend);
+    close(fd);
+    return time;
+}
+
+#ifdef BENCH_CURSES
+double benchRenderCurses(BenchState* state, long long iterations) {
+    char lines[16];
+    char columns[16];
+    snprintf(lines, sizeof(lines), "%d", RENDER_LINES);
+    snprintf(columns, sizeof(columns), "%d", RENDER_COLUMNS);
+    setenv("LINES", lines, 1);
+    setenv("COLUMNS", columns, 1);
+    FILE* out = fopen("/dev/null", "w");
+    FILE* in = fopen("/dev/null", "r");
+    SCREEN* screen = newterm("xterm", out, in);
+    if (screen == NULL) {
+        fclose(out);
+        fclose(in);
+        return -1;
+    }
+    createColorPairs();
+    RenderBackend backend;
+    initCursesBackend(&backend);
+    double time = benchRenderWith(state, iterations, &backend);
+    freeBackend(&backend);
+    endwin();
+    delscreen(screen);
+    fclose(out);
+    fclose(in);
+    return time;
+}
+#endif
+
+Benchmark benchmarks[] = {
+    { "initBoard", benchInitBoard, 1 },
+    { "findRow", benchFindRow, 0 },
+    { "levelSolvable", benchLevelSolvable, 1 },
+    { "updateCars", benchUpdateCars, 1 },
+    { "checkCollision", benchCheckCollision, 1 },
+    { "moveObject", benchMoveObject, 1 },
+    { "updateStork", benchUpdateStork, 1 },
+    { "saveSnapshot", benchSaveSnapshot, 1 },
+    { "render_null", benchRenderNull, 1 },
+    { "render_ansi", benchRenderAnsi, 1 },
+#ifdef BENCH_CURSES
+    { "render_curses", benchRenderCurses, 1 },
+#endif
+};
+
+//****************
+//* RUNNING THEM *
+//****************
+
+// Function to run a benchmark more and more times until it takes at least min_time seconds
+void runBenchmark(const Benchmark* benchmark, BenchState* state, double min_time) {
+    long long iterations = 1;
+    while (true) {
+        long long allocations = heapAllocations();
+        double time = benchmark->function(state, iterations);
+        allocations = heapAllocations() - allocations;
+        if (time < 0) {
+            printf("%s,%d,%d,%d,%d,skipped,,\n", benchmark->name, state->board.rows, state->board.cols, state->board.num_roads,
+                state->cars_per_road);
+            return;
+        }
+        if (time >= min_time * 1e9 || iterations >= (1LL << 40)) {
+            long long ops = iterations * (benchmark->ops_per_iteration > 0 ? benchmark->ops_per_iteration : state->board.num_roads);
+            if (ops == 0) {
+                ops = 1;
+            }
+            printf("%s,%d,%d,%d,%d,%.1f,%.3f,%lld\n", benchmark->name, state->board.rows, state->board.cols,
+                state->board.num_roads, state->cars_per_road, time / ops, double(allocations) / ops, ops);
+            fflush(stdout);
+            return;
+        }
+        // guessing how many times are needed, but at most 10 times more than now
+        long long guess = time > 0 ? (long long)(iterations * min_time * 1.2e9 / time) : iterations * 10;
+        iterations = guess > iterations * 10 ? iterations * 10 : guess + 1;
+    }
+}
+
+// Function to read a list like "26x50,1000x1000"
+int parseSizes(const char* text, int* rows, int* cols) {
+    int count = 0;
+    while (*text != '\0' && count < MAX_CASES) {
+        if (sscanf(text, "%dx%d", &rows[count], &cols[count]) != 2 || rows[count] < 4 || cols[count] < 3) {
+            return -1;
+        }
+        count++;
+        text = strchr(text, ',');
+        if (text == NULL) {
+            break;
+        }
+        text++;
+    }
+    return count;
+}
+
+int parseNumbers(const char* text, int* numbers) {
+    int count = 0;
+    while (*text != '\0' && count < MAX_CASES) {
+        numbers[count++] = atoi(text);
+        text = strchr(text, ',');
+        if (text == NULL) {
+            break;
+        }
+        text++;
+    }
+    return count;
+}
+
+//*****************
+//* MAIN FUNCTION *
+//*****************
+
+int main(int argc, char** argv) {
+    const char* sizes = DEFAULT_SIZES;
+    const char* roads_text = DEFAULT_ROADS;
+    const char* cars_text = DEFAULT_CARS;
+    const char* only = NULL;
+    double min_time = DEFAULT_MIN_TIME;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--sizes") == 0) {
+            sizes = argv[i + 1];
+        }
+        else if (strcmp(argv[i], "--roads") == 0) {
+            roads_text = argv[i + 1];
+        }
+        else if (strcmp(argv[i], "--cars") == 0) {
+            cars_text = argv[i + 1];
+        }
+        else if (strcmp(argv[i], "--min-time") == 0) {
+            min_time = atof(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--only") == 0) {
+            only = argv[i + 1];
+        }
+        else {
+            printf("Unknown option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+    int rows[MAX_CASES];
+    int cols[MAX_CASES];
+    int roads[MAX_CASES];
+    int cars[MAX_CASES];
+    int num_sizes = parseSizes(sizes, rows, cols);
+    int num_roads = parseNumbers(roads_text, roads);
+    int num_cars = parseNumbers(cars_text, cars);
+    if (num_sizes <= 0 || num_roads <= 0 || num_cars <= 0) {
+        printf("Error: the sizes are given as RxC,RxC (at least 4x3), the roads and the cars as N,N\n");
+        return 1;
+    }
+
+    printf("benchmark,rows,cols,roads,cars_per_road,ns_per_op,allocs_per_op,ops\n");
+    for (int s = 0; s < num_sizes; s++) {
+        for (int r = 0; r < num_roads; r++) {
+            for (int c = 0; c < num_cars; c++) {
+                BenchState* state = new BenchState;
+                initState(state, rows[s], cols[s], roads[r], cars[c] > 1 ? cars[c] : 1);
+                for (size_t b = 0; b < sizeof(benchmarks) / sizeof(benchmarks[0]); b++) {
+                    if (only == NULL || strcmp(only, benchmarks[b].name) == 0) {
+                        runBenchmark(&benchmarks[b], state, min_time);
+                    }
+                }
+                freeState(state);
+                delete state;
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - clock of the game loops
+    Version: 1.0
+
+    The engine only counts steps, so a game is the same at any speed. The
+    loops that play it in front of a player ask this clock what time it is
+    and how long to sleep. The real clock is the one with speed 1, a faster
+    or slower one scales the real time. The one that is as fast as possible
+    doesn't sleep at all: a wait moves its time forward at once, unless a
+    key is already waiting.
+*/
+
+#include <math.h>
+#include <poll.h>
+#include <time.h>
+#include "clock.h"
+
+//*******************
+//* CLOCK FUNCTIONS *
+//*******************
+
+// Function to get the wall clock time in seconds, unlike clock() it doesn't depend on the CPU load
+double realTime() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+void initClock(Clock* clock, double speed) {
+    clock->speed = speed;
+    clock->real_start = realTime();
+    clock->start = 0.0;
+    clock->virtual_time = 0.0;
+}
+
+double clockTime(const Clock* clock) {
+    return clockTimeAt(clock, realTime());
+}
+
+// Function to get the time of the clock at the given real time (e.g. when a key was pressed),
+// for the clock that never waits it is the time it has now
+double clockTimeAt(const Clock* clock, double real_time) {
+    if (clock->speed == CLOCK_AS_FAST_AS_POSSIBLE) {
+        return clock->virtual_time;
+    }
+    return clock->start + (real_time - clock->real_start) * clock->speed;
+}
+
+// Function to change the speed, the time of the clock goes on from where it is
+void setClockSpeed(Clock* clock, double speed) {
+    double now = clockTime(clock);
+    clock->speed = speed;
+    clock->real_start = realTime();
+    clock->start = now;
+    clock->virtual_time = now;
+}
+
+// Function to wait the given time of the clock or until there is something to read in fd (-1 for no fd).
+// Returns true if fd can be read
+bool waitClock(Clock* clock, double seconds, int fd) {
+    pollfd input;
+    input.fd = fd;
+    input.events = POLLIN;
+    if (clock->speed == CLOCK_AS_FAST_AS_POSSIBLE) {
+        if (fd >= 0 && poll(&input, 1, 0) > 0) {
+            return true;
+        }
+        if (seconds > 0) {
+            clock->virtual_time += seconds;
+        }
+        return false;
+    }
+    if (seconds <= 0) {
+        return false;
+    }
+    int timeout = int(ceil(seconds / clock->speed * 1000));
+    if (fd < 0) {
+        poll(NULL, 0, timeout);
+        return false;
+    }
+    return poll(&input, 1, timeout) > 0;
+}
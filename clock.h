@@ -0,0 +1,38 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - clock of the game loops
+    Version: 1.0
+*/
+
+#ifndef CLOCK_H
+#define CLOCK_H
+
+//**********************
+//* DEFINING CONSTANTS *
+//**********************
+
+#define CLOCK_AS_FAST_AS_POSSIBLE 0.0 // THE SPEED OF A CLOCK THAT NEVER WAITS
+
+//***********************
+//* DEFINING STRUCTURES *
+//***********************
+
+struct Clock { // The time that a loop follows: the real time, a faster or slower one, or one that never waits
+    double speed; // Seconds of the clock per real second, CLOCK_AS_FAST_AS_POSSIBLE to jump over every wait
+    double real_start; // Real time when the speed was set the last time
+    double start; // Time of the clock then
+    double virtual_time; // Time of the clock that never waits, moved only by waitClock
+};
+
+//*******************
+//* CLOCK FUNCTIONS *
+//*******************
+
+double realTime();
+void initClock(Clock* clock, double speed);
+double clockTime(const Clock* clock);
+double clockTimeAt(const Clock* clock, double real_time);
+void setClockSpeed(Clock* clock, double speed);
+bool waitClock(Clock* clock, double seconds, int fd);
+
+#endif
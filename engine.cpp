@@ -0,0 +1,1324 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - simulation engine
+    Version: 1.0
+
+    Everything in this file works without a terminal. The board size is given
+    explicitly and time is the simulated time passed in by step(), so the same
+    code is used by the curses game and by the headless runs.
+*/
+
+#include "engine.h"
+#include "pipeline.h"
+#include "profiler.h"
+#include "replay.h"
+#include "solver.h"
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//****************************
+//* FREE THE MEMORY FUNCTION *
+//****************************
+
+void freeMemory(Board* board, Object* frog, Timer* timer, Stork* stork) {
+    freeArena(&board->arena); // everything the levels of the board used
+    delete board;
+    delete frog;
+    delete timer;
+    delete stork;
+}
+
+//***************************
+//* TIMER RELATED FUNCTIONS *
+//***************************
+
+void initTimer(Timer* timer, double now) {
+    timer->start_time = now;
+    timer->current_time = 0.00;
+    timer->speed_changes = 0;
+}
+
+void updateTimer(Timer* timer, double now) {
+    timer->current_time = now - timer->start_time; // getting the current time in seconds
+}
+
+//******************
+//* RANDOM NUMBERS *
+//******************
+
+// Function to get the key of the given stream of the seed. The seed is mixed so that close seeds (and streams)
+// give different numbers
+uint64_t streamKey(uint64_t seed, uint64_t stream) {
+    return mixBits(mixBits(seed + 0x9E3779B97F4A7C15ULL) + stream);
+}
+
+// Function to start the random numbers of a level, the numbers of the play come first
+void seedRandom(Board* board, unsigned long long seed) {
+    board->random_seed = seed;
+    board->spawn_key = streamKey(seed, RANDOM_SPAWN_STREAM);
+    startRandomStream(board, RANDOM_PLAY_STREAM);
+}
+
+// Function to take the next random numbers from the given stream of the seed, from its first number
+void startRandomStream(Board* board, uint64_t stream) {
+    board->random.key = streamKey(board->random_seed, stream);
+    board->random.counter = 0;
+}
+
+// Random number from 0 to n - 1, the next one of the stream
+int randomInt(Board* board, int n) {
+    uint64_t x = randomAt(board->random.key, board->random.counter++);
+    return int(((x >> 32) * (uint64_t)n) >> 32);
+}
+
+//***************************
+//* BOARD RELATED FUNCTIONS *
+//***************************
+
+// Functions to get the size of the distance field of the stork, it never covers more than the board
+int fieldRadiusX(int rows) {
+    return rows - 1 < STORK_FIELD_RADIUS ? rows - 1 : STORK_FIELD_RADIUS;
+}
+
+int fieldRadiusY(int cols) {
+    return cols - 2 < STORK_FIELD_RADIUS ? cols - 2 : STORK_FIELD_RADIUS;
+}
+
+int fieldWords(int cols) {
+    return 2 * fieldRadiusY(cols) / 64 + 2; // the columns may start anywhere in a word
+}
+
+// Function to get the size of the arena that fits any level of a board of the given size
+size_t boardMemorySize(int rows, int cols, int cars_per_road) {
+    int max_roads = MAXIMUM(rows);
+    size_t max_cars = (size_t)max_roads * (cars_per_road > 1 ? cars_per_road : 1);
+    int words = (cols + 63) / 64;
+    size_t size = 0;
+    size += arenaSpace(rows * sizeof(char*)) + arenaSpace((size_t)rows * cols); // grid
+    size += arenaSpace((size_t)rows * words * sizeof(uint64_t)); // obstacles
+    size += 2 * arenaSpace((rows + 63) / 64 * sizeof(uint64_t)); // free rows and road rows
+    size += arenaSpace(max_roads * sizeof(Road));
+    size += 8 * arenaSpace(max_cars * sizeof(int)) + arenaSpace(max_cars * sizeof(char)); // cars
+    size += arenaSpace(WHEEL_SLOTS * sizeof(int)) + 3 * arenaSpace((max_cars + max_roads) * sizeof(int)); // timing wheel
+    size += arenaSpace(max_cars * sizeof(int)) + arenaSpace(max_roads * sizeof(int));
+    int field_rows = 2 * fieldRadiusX(rows) + 1;
+    int field_words = fieldWords(cols);
+    size += arenaSpace((size_t)field_rows * (2 * fieldRadiusY(cols) + 1) * sizeof(int)); // distance field of the stork
+    size += 3 * arenaSpace((size_t)field_rows * field_words * sizeof(uint64_t)) + 2 * arenaSpace(field_words * sizeof(uint64_t));
+    size += solverMemorySize(rows, cols);
+    size += arenaSpace(rows * sizeof(int)); // occupancy
+    size += arenaSpace((size_t)max_roads * words * sizeof(uint64_t));
+    size += arenaSpace((size_t)rows * words * sizeof(uint64_t));
+    return size;
+}
+
+// Function to initialize the grid of the board
+void initGrid(Board* board) {
+    board->grid = (char**)arenaAlloc(&board->arena, board->rows * sizeof(char*));
+    char* cells = (char*)arenaAlloc(&board->arena, (size_t)board->rows * board->cols);
+    for (int i = 0; i < board->rows; i++) {
+        board->grid[i] = cells + (size_t)i * board->cols;
+        for (int j = 0; j < board->cols - 1; j++) {
+            board->grid[i][j] = ' ';
+        }
+        board->grid[i][board->cols - 1] = '\0';
+    }
+}
+
+// Find a free row for the road: a random row, or the first free row after it
+void findRow(Board* board, int i) {
+    int x = randomInt(board, board->rows - 2) + 1; // Random road position
+    int row_words = (board->rows + 63) / 64;
+    for (int pass = 0; pass < 2; pass++) { // the second time from the first row
+        for (int w = x / 64; w < row_words; w++) {
+            uint64_t bits = board->free_rows[w];
+            if (w == x / 64) {
+                bits &= ~0ULL << (x % 64);
+            }
+            if (bits != 0) {
+                board->roads[i].x = w * 64 + __builtin_ctzll(bits);
+                return;
+            }
+        }
+        x = 1;
+    }
+}
+
+// Function to turn the speed (moves per second) into the number of steps between two moves
+int moveInterval(int speed, int tick_rate) {
+    if (speed <= 0) {
+        return 1 << 29; // the car doesn't move
+    }
+    return (tick_rate + speed - 1) / speed; // the same as waiting for at least 1 / speed seconds
+}
+
+// Function to make the empty timing wheel for the given number of cars and roads, tick is the step that was simulated last
+void initWheel(TimingWheel* wheel, int count, int roads, long long tick, Arena* arena) {
+    wheel->tick = tick;
+    wheel->head = (int*)arenaAlloc(arena, WHEEL_SLOTS * sizeof(int));
+    wheel->next = (int*)arenaAlloc(arena, (count + roads) * sizeof(int));
+    wheel->prev = (int*)arenaAlloc(arena, (count + roads) * sizeof(int));
+    wheel->slot = (int*)arenaAlloc(arena, (count + roads) * sizeof(int));
+    wheel->due = (int*)arenaAlloc(arena, count * sizeof(int));
+    wheel->spawning = (int*)arenaAlloc(arena, roads * sizeof(int));
+    memset(wheel->head, -1, WHEEL_SLOTS * sizeof(int));
+    memset(wheel->slot, -1, (count + roads) * sizeof(int));
+}
+
+// Function to put the entry into the slot of the given step, an entry that is late is due in the next step
+void scheduleEntry(TimingWheel* wheel, int i, long long when) {
+    if (when <= wheel->tick) {
+        when = wheel->tick + 1;
+    }
+    int slot = int(when & (WHEEL_SLOTS - 1));
+    wheel->slot[i] = slot;
+    wheel->prev[i] = -1;
+    wheel->next[i] = wheel->head[slot];
+    if (wheel->head[slot] >= 0) {
+        wheel->prev[wheel->head[slot]] = i;
+    }
+    wheel->head[slot] = i;
+}
+
+void unscheduleEntry(TimingWheel* wheel, int i) {
+    if (wheel->slot[i] < 0) {
+        return;
+    }
+    if (wheel->prev[i] >= 0) {
+        wheel->next[wheel->prev[i]] = wheel->next[i];
+    }
+    else {
+        wheel->head[wheel->slot[i]] = wheel->next[i];
+    }
+    if (wheel->next[i] >= 0) {
+        wheel->prev[wheel->next[i]] = wheel->prev[i];
+    }
+    wheel->slot[i] = -1;
+}
+
+// Function to put the car into the slot of the step of its next move
+void scheduleCar(Board* board, int i) {
+    scheduleEntry(&board->wheel, i, board->cars.next_move[i]);
+}
+
+void unscheduleCar(Board* board, int i) {
+    unscheduleEntry(&board->wheel, i);
+}
+
+// Function to check if a new car fits at the edge where the cars come onto the road
+bool entryFree(const Board* board, int road) {
+    const Road* lane = &board->roads[road];
+    if (lane->count == 0) {
+        return true;
+    }
+    if (lane->count == board->cars.per_road) {
+        return false;
+    }
+    int entry = lane->direction == 1 ? 0 : board->cols - 2;
+    int last = laneSlot(board, road, lane->count - 1);
+    return (board->cars.y[last] - entry) * lane->direction >= CAR_SPACING;
+}
+
+// Function to check if a new car comes onto the road in the given step, if its entry is free then. It happens
+// CAR_SPAWN_RATE times per second on average, every road and step has its own number so it is known ahead
+bool spawnTrial(const Board* board, int road, long long tick) {
+    uint64_t x = randomAt(board->spawn_key, (uint64_t)tick * board->num_roads + road);
+    return int(((x >> 32) * (uint64_t)board->tick_rate) >> 32) < CAR_SPAWN_RATE;
+}
+
+// Function to keep the next new car of the road in the wheel while the entry of the road is free and out of it
+// while it isn't, it is called after every change of the road. Tick is the step that is simulated now
+void scheduleSpawn(Board* board, int road, long long tick) {
+    if (board->cars.per_road == 1) {
+        return; // the only car of a road always comes back
+    }
+    Road* lane = &board->roads[road];
+    int entry = board->cars.count + road;
+    bool free = entryFree(board, road);
+    if (free && lane->next_spawn > tick) {
+        return; // it waits already
+    }
+    unscheduleEntry(&board->wheel, entry);
+    lane->next_spawn = -1;
+    if (!free) {
+        return;
+    }
+    long long when = tick + 1;
+    while (when < tick + SPAWN_LOOKAHEAD && !spawnTrial(board, road, when)) {
+        when++;
+    }
+    lane->next_spawn = int(when);
+    scheduleEntry(&board->wheel, entry, when);
+}
+
+// Function to move a level that was made in the step 0 to the given step: the cars move on from there
+void startLevel(Board* board, long long tick) {
+    TimingWheel* wheel = &board->wheel;
+    memset(wheel->head, -1, WHEEL_SLOTS * sizeof(int));
+    memset(wheel->slot, -1, (board->cars.count + board->num_roads) * sizeof(int));
+    wheel->tick = tick;
+    for (int i = 0; i < board->cars.count; i++) {
+        if (board->cars.active[i]) {
+            board->cars.next_move[i] += int(tick);
+            scheduleCar(board, i);
+        }
+    }
+    for (int road = 0; road < board->num_roads; road++) {
+        board->roads[road].next_spawn = -1;
+        scheduleSpawn(board, road, tick);
+    }
+}
+
+// Function to give the car a random speed
+void setCarSpeed(Board* board, int i, int speed) {
+    CarStore* cars = &board->cars;
+    int old_interval = cars->move_interval[i];
+    cars->speed[i] = speed;
+    cars->move_interval[i] = moveInterval(speed, board->tick_rate);
+    cars->next_move[i] += cars->move_interval[i] - old_interval; // the car keeps the time of its last move
+    unscheduleCar(board, i);
+    scheduleCar(board, i);
+}
+
+// Function to initialize the car in the given slot of the road (already taken with pushCar).
+// The only car on a road decides the direction of the road, the other cars drive the same way
+void initCar(Board* board, int road, int i, long long tick) {
+    CarStore* cars = &board->cars;
+    cars->x[i] = board->roads[road].x;
+    int left_right = randomInt(board, 2); // The car is placed randomly on left or right edge of the row
+    if (board->roads[road].count == 1) { // the only car on the road
+        board->roads[road].direction = left_right == 0 ? 1 : -1;
+    }
+    cars->direction[i] = board->roads[road].direction;
+    if (cars->direction[i] == 1) { // Car spawns on the left edge and is moving to right edge
+        cars->y[i] = 0;
+    }
+    else { // Car spawns on the right edge and is moving to left edge
+        cars->y[i] = board->cols - 2;
+    }
+    int which_symbol = randomInt(board, 3);
+    if (which_symbol == 0) {
+        cars->symbol[i] = 'C';
+    }
+    else if (which_symbol == 1) {
+        cars->symbol[i] = 'S';
+    }
+    else {
+        cars->symbol[i] = 'F';
+    }
+    cars->stopping[i] = cars->symbol[i] == 'S';
+    cars->speed[i] = board->car_min_speed + randomInt(board, board->car_max_speed - board->car_min_speed + 1); // Random speed of the car
+    cars->move_interval[i] = moveInterval(cars->speed[i], board->tick_rate);
+    cars->next_move[i] = int(tick) + cars->move_interval[i];
+    scheduleCar(board, i);
+}
+
+// Function to make room for the given number of cars
+void initCarStore(CarStore* cars, int count, int per_road, Arena* arena) {
+    cars->count = count;
+    cars->per_road = per_road;
+    cars->x = (int*)arenaAlloc(arena, count * sizeof(int));
+    cars->y = (int*)arenaAlloc(arena, count * sizeof(int));
+    cars->direction = (int*)arenaAlloc(arena, count * sizeof(int));
+    cars->speed = (int*)arenaAlloc(arena, count * sizeof(int));
+    cars->move_interval = (int*)arenaAlloc(arena, count * sizeof(int));
+    cars->next_move = (int*)arenaAlloc(arena, count * sizeof(int));
+    cars->stopping = (int*)arenaAlloc(arena, count * sizeof(int));
+    cars->active = (int*)arenaAlloc(arena, count * sizeof(int));
+    cars->symbol = (char*)arenaAlloc(arena, count * sizeof(char));
+    memset(cars->active, 0, count * sizeof(int));
+}
+
+// Function to take the slot behind the last car of the road, returns the slot
+int pushCar(Board* board, int road) {
+    int i = laneSlot(board, road, board->roads[road].count);
+    board->roads[road].count++;
+    board->cars.active[i] = 1;
+    return i;
+}
+
+// Function to take the car in front off the road, returns its slot
+int popCar(Board* board, int road) {
+    int i = laneSlot(board, road, 0);
+    Road* lane = &board->roads[road];
+    lane->first = lane->first + 1 == board->cars.per_road ? 0 : lane->first + 1;
+    lane->count--;
+    board->cars.active[i] = 0;
+    unscheduleCar(board, i);
+    return i;
+}
+
+// Function to initialize the roads of the board
+void initRoads(Board* board, long long tick, int roads) {
+    if (roads > 0) { // a fixed number of roads, there can't be more than the free rows
+        board->num_roads = roads < MAXIMUM(board->rows) ? roads : MAXIMUM(board->rows);
+    }
+    else {
+        board->num_roads = MINIMUM(board->rows) + randomInt(board, MAXIMUM(board->rows) - MINIMUM(board->rows) + 1); // Random number of roads
+    }
+    board->roads = (Road*)arenaAlloc(&board->arena, board->num_roads * sizeof(Road));
+    initCarStore(&board->cars, board->num_roads * board->cars_per_road, board->cars_per_road, &board->arena);
+    initWheel(&board->wheel, board->cars.count, board->num_roads, tick, &board->arena);
+    for (int i = 0; i < board->num_roads; i++) {
+        findRow(board, i); // Calling a function to find a free row for the road
+        clearBit(board->free_rows, board->roads[i].x); // Marking the row as occupied
+        setBit(board->road_rows, board->roads[i].x);
+        memset(obstacleBits(board, board->roads[i].x), 0, board->words * sizeof(uint64_t)); // roads have no obstacles
+        board->roads[i].first = 0;
+        board->roads[i].count = 0;
+        board->roads[i].next_spawn = -1;
+        initCar(board, i, pushCar(board, i), tick); // every road starts with one car, the others come later
+    }
+    for (int i = 0; i < board->num_roads; i++) {
+        scheduleSpawn(board, i, tick);
+    }
+}
+
+// Function to mark the cells taken by the cars, the stork is put on the board later
+void initOccupancy(Board* board) {
+    Occupancy* occupancy = &board->occupancy;
+    occupancy->words = (board->cols + 63) / 64;
+    occupancy->road_of_row = (int*)arenaAlloc(&board->arena, board->rows * sizeof(int));
+    for (int i = 0; i < board->rows; i++) {
+        occupancy->road_of_row[i] = -1;
+    }
+    size_t car_bytes = (size_t)board->num_roads * occupancy->words * sizeof(uint64_t);
+    size_t stork_bytes = (size_t)board->rows * occupancy->words * sizeof(uint64_t);
+    occupancy->cars = (uint64_t*)arenaAlloc(&board->arena, car_bytes);
+    occupancy->storks = (uint64_t*)arenaAlloc(&board->arena, stork_bytes);
+    memset(occupancy->cars, 0, car_bytes);
+    memset(occupancy->storks, 0, stork_bytes);
+    for (int i = 0; i < board->num_roads; i++) {
+        occupancy->road_of_row[board->roads[i].x] = i;
+        for (int j = 0; j < board->roads[i].count; j++) {
+            setBit(carBits(occupancy, i), board->cars.y[laneSlot(board, i, j)]);
+        }
+    }
+}
+
+// Function to make room for the distance field of the stork, it is made when the stork needs it
+void initDistanceField(Board* board) {
+    DistanceField* field = &board->stork_field;
+    field->radius_x = fieldRadiusX(board->rows);
+    field->radius_y = fieldRadiusY(board->cols);
+    field->frog_x = -1;
+    field->frog_y = -1;
+    int rows = 2 * field->radius_x + 1;
+    int words = fieldWords(board->cols);
+    field->masks = (uint64_t*)arenaAlloc(&board->arena, words * sizeof(uint64_t));
+    field->visited = (uint64_t*)arenaAlloc(&board->arena, (size_t)rows * words * sizeof(uint64_t));
+    field->frontier = (uint64_t*)arenaAlloc(&board->arena, (size_t)rows * words * sizeof(uint64_t));
+    field->next = (uint64_t*)arenaAlloc(&board->arena, (size_t)rows * words * sizeof(uint64_t));
+    field->around = (uint64_t*)arenaAlloc(&board->arena, words * sizeof(uint64_t));
+    field->distance = (int*)arenaAlloc(&board->arena, (size_t)rows * (2 * field->radius_y + 1) * sizeof(int));
+}
+
+// Function to make a random level on the board
+void makeLevel(Board* board, int rows, int cols, int MINSPEED, int MAXSPEED, int tick_rate, long long tick, int roads, int cars_per_road) {
+    board->rows = rows;
+    board->cols = cols;
+    resetArena(&board->arena); // the previous level isn't needed anymore
+    board->words = (board->cols + 63) / 64;
+    int row_words = (board->rows + 63) / 64;
+    size_t obstacle_bytes = (size_t)board->rows * board->words * sizeof(uint64_t);
+    board->obstacles = (uint64_t*)arenaAlloc(&board->arena, obstacle_bytes);
+    board->free_rows = (uint64_t*)arenaAlloc(&board->arena, row_words * sizeof(uint64_t));
+    board->road_rows = (uint64_t*)arenaAlloc(&board->arena, row_words * sizeof(uint64_t));
+    memset(board->obstacles, 0, obstacle_bytes);
+    memset(board->free_rows, 0, row_words * sizeof(uint64_t));
+    memset(board->road_rows, 0, row_words * sizeof(uint64_t));
+    for (int i = 1; i < board->rows - 1; i++) { // the start and end rows are never free
+        setBit(board->free_rows, i);
+        int distance_between_obstacles = randomInt(board, 5) + 1;
+        if (distance_between_obstacles != 1) {
+            uint64_t* obstacles = obstacleBits(board, i);
+            for (int j = 0; j < board->cols - 1; j += distance_between_obstacles) {
+                setBit(obstacles, j);
+            }
+        }
+    }
+    board->car_min_speed = MINSPEED;
+    board->car_max_speed = MAXSPEED;
+    board->tick_rate = tick_rate;
+    board->cars_per_road = cars_per_road > 1 ? cars_per_road : 1;
+    board->spaces_count = 0;
+    board->friendly_on = false;
+    initGrid(board);
+    initRoads(board, tick, roads);
+    initOccupancy(board);
+    initDistanceField(board);
+}
+
+// Function to initialize the board, the arena of the board has to fit boardMemorySize(rows, cols, cars_per_road).
+// roads is the number of roads, 0 for a random number like in the game. A level that a frog with the given speed
+// can't win is made again (at most LEVEL_TRIES times), frog_speed 0 takes the first level
+void initBoard(Board* board, int rows, int cols, int MINSPEED, int MAXSPEED, int tick_rate, long long tick, int roads, int cars_per_road, int frog_speed) {
+    for (int tries = 1; ; tries++) {
+        startRandomStream(board, RANDOM_LEVEL_STREAM + tries - 1); // every try has its own numbers
+        makeLevel(board, rows, cols, MINSPEED, MAXSPEED, tick_rate, tick, roads, cars_per_road);
+        if (frog_speed <= 0 || tries == LEVEL_TRIES || levelSolvable(board, frog_speed, tick)) {
+            break;
+        }
+    }
+    startRandomStream(board, RANDOM_PLAY_STREAM); // the play doesn't depend on how many tries it took
+}
+
+//***********************
+//* ROW QUERY FUNCTIONS *
+//***********************
+
+// Open cells (no obstacle) in the word w of the given row, the bits behind the board are never open
+uint64_t openWord(const Board* board, int row, int w) {
+    int width = board->cols - 1; // the last column of the grid is never used
+    int first = w * 64;
+    if (first >= width) {
+        return 0;
+    }
+    uint64_t open = ~obstacleBits(board, row)[w];
+    if (width - first < 64) {
+        open &= (uint64_t(1) << (width - first)) - 1;
+    }
+    return open;
+}
+
+// Function to get the cells of a row that the frog can stand on, a word at a time
+void openCells(const Board* board, int row, uint64_t* out) {
+    for (int w = 0; w < board->words; w++) {
+        out[w] = openWord(board, row, w);
+    }
+}
+
+// Function to count the open cells of a row between the columns from and to (both included)
+int countOpenCells(const Board* board, int row, int from, int to) {
+    if (from < 0) {
+        from = 0;
+    }
+    if (to > board->cols - 2) {
+        to = board->cols - 2;
+    }
+    int count = 0;
+    for (int w = from / 64; from <= to && w <= to / 64; w++) {
+        uint64_t open = openWord(board, row, w);
+        if (w == from / 64) {
+            open &= ~uint64_t(0) << (from % 64);
+        }
+        if (w == to / 64 && to % 64 != 63) {
+            open &= (uint64_t(2) << (to % 64)) - 1;
+        }
+        count += __builtin_popcountll(open);
+    }
+    return count;
+}
+
+uint64_t reverseBits(uint64_t x) {
+    x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+    x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+    x = ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+    x = ((x >> 8) & 0x00FF00FF00FF00FFULL) | ((x & 0x00FF00FF00FF00FFULL) << 8);
+    x = ((x >> 16) & 0x0000FFFF0000FFFFULL) | ((x & 0x0000FFFF0000FFFFULL) << 16);
+    return (x >> 32) | (x << 32);
+}
+
+// Function to grow the seeds of one word to the ends of their runs of open cells, towards the
+// higher bits. Adding the seeds to the open bits carries through every run that has a seed, the
+// carry is what reaches the next word.
+uint64_t fillRuns(uint64_t open, uint64_t seeds, uint64_t* carry) {
+    uint64_t sum = open + seeds;
+    uint64_t carry_out = sum < open;
+    sum += *carry;
+    carry_out |= *carry && sum == 0;
+    *carry = carry_out;
+    return ((sum ^ open) & open) | seeds;
+}
+
+// Function to get the columns of the given row that the frog can reach from the given
+// columns of the row next to it: it jumps into an open cell and then walks along the row
+void reachableColumns(const Board* board, int row, const uint64_t* from, uint64_t* out) {
+    uint64_t carry = 0;
+    for (int w = 0; w < board->words; w++) { // walking right, from the lowest word
+        uint64_t open = openWord(board, row, w);
+        out[w] = fillRuns(open, from[w] & open, &carry);
+    }
+    carry = 0;
+    for (int w = board->words - 1; w >= 0; w--) { // walking left, the same with the bits reversed
+        uint64_t open = reverseBits(openWord(board, row, w));
+        out[w] |= reverseBits(fillRuns(open, reverseBits(out[w]), &carry));
+    }
+}
+
+//*************************
+//* CAR RELATED FUNCTIONS *
+//*************************
+
+// Changing the friendly cars on demand
+void FriendlyOnOff(Board* board) {
+    board->spaces_count++;
+    for (int i = 0; i < board->cars.count; i++) {
+        if (board->cars.active[i] && board->cars.symbol[i] == 'F') {
+            if (board->spaces_count % 2 == 0) {
+                board->friendly_on = false;
+            }
+            else {
+                board->friendly_on = true;
+            }
+        }
+    }
+}
+
+// Function to decide if the car that drove off the board is gone for good, the friendly cars always come back
+bool disappearCar(Board* board, int i) {
+    int disappear = randomInt(board, 2);
+    return disappear && board->cars.symbol[i] != 'F';
+}
+
+// Function to copy the car to another slot, when a car comes back on the other edge of the road
+void copyCar(CarStore* cars, int from, int to) {
+    if (from == to) {
+        return;
+    }
+    cars->x[to] = cars->x[from];
+    cars->y[to] = cars->y[from];
+    cars->direction[to] = cars->direction[from];
+    cars->speed[to] = cars->speed[from];
+    cars->move_interval[to] = cars->move_interval[from];
+    cars->next_move[to] = cars->next_move[from];
+    cars->stopping[to] = cars->stopping[from];
+    cars->symbol[to] = cars->symbol[from];
+}
+
+// Function to check if the car has to wait: it is too close to the car in front of it,
+// or it is an 'S' car and the frog is right in front of it
+bool carWaits(const Board* board, int i, const Object* frog) {
+    const CarStore* cars = &board->cars;
+    int ahead = (frog->y - cars->y[i]) * cars->direction[i]; // how far in front of the car the frog is
+    bool near_frog = cars->x[i] == frog->x || cars->x[i] == frog->x - 1;
+    if (cars->stopping[i] && near_frog && ahead > 0 && ahead <= 2) {
+        return true;
+    }
+    int road = i / cars->per_road;
+    if (i == laneSlot(board, road, 0)) {
+        return false; // nobody in front of it
+    }
+    int leader = i == road * cars->per_road ? i + cars->per_road - 1 : i - 1; // the previous slot of the ring
+    return (cars->y[leader] - cars->y[i]) * cars->direction[i] <= CAR_SPACING;
+}
+
+// Function to deal with the car in front of the road after it drove off the board: it comes back on the
+// other edge or a new car comes instead, if there is room for it
+void leaveRoad(Board* board, Object* frog, int road, int riding, long long tick) {
+    CarStore* cars = &board->cars;
+    int i = popCar(board, road);
+    bool right_edge = cars->y[i] >= board->cols - 1;
+    if (!disappearCar(board, i)) {
+        if (i == riding) {
+            frog->y = right_edge ? board->cols - 2 : 0;
+            frog->on_friendly_car = false;
+        }
+        if (entryFree(board, road)) {
+            int j = pushCar(board, road);
+            copyCar(cars, i, j);
+            cars->y[j] = right_edge ? 0 : board->cols - 2;
+            scheduleCar(board, j);
+            setBit(carBits(&board->occupancy, road), cars->y[j]);
+        }
+    }
+    else if (entryFree(board, road)) {
+        int j = pushCar(board, road);
+        initCar(board, road, j, tick);
+        setBit(carBits(&board->occupancy, road), cars->y[j]);
+    }
+    scheduleSpawn(board, road, tick);
+}
+
+// Function to bring the new cars that are due onto their roads, if the entries are still free
+void spawnCars(Board* board, int num_spawning, long long tick) {
+    int* spawning = board->wheel.spawning;
+    for (int k = 1; k < num_spawning; k++) { // in the order of the roads, so the random numbers are drawn in the same order
+        int road = spawning[k];
+        int j = k;
+        while (j > 0 && spawning[j - 1] > road) {
+            spawning[j] = spawning[j - 1];
+            j--;
+        }
+        spawning[j] = road;
+    }
+    for (int k = 0; k < num_spawning; k++) {
+        int road = spawning[k];
+        if (entryFree(board, road) && spawnTrial(board, road, tick)) {
+            int i = pushCar(board, road);
+            initCar(board, road, i, tick);
+            setBit(carBits(&board->occupancy, road), board->cars.y[i]);
+        }
+        scheduleSpawn(board, road, tick); // the next one
+    }
+}
+
+// Update the position of the cars, only the cars in the slot of the timing wheel for this step are looked at
+void updateCars(Board* board, Object* frog, long long tick) {
+    CarStore* cars = &board->cars;
+    TimingWheel* wheel = &board->wheel;
+    int width = board->cols - 1;
+    wheel->tick = tick;
+
+    // taking the due cars out of the slot, the cars of the later rounds of the wheel stay in it. The new cars
+    // that are due stay too, they come after the cars moved
+    int num_due = 0;
+    int num_spawning = 0;
+    int i = wheel->head[tick & (WHEEL_SLOTS - 1)];
+    while (i >= 0) {
+        int next = wheel->next[i];
+        if (i >= cars->count) {
+            if (board->roads[i - cars->count].next_spawn <= tick) {
+                wheel->spawning[num_spawning++] = i - cars->count;
+            }
+        }
+        else if (cars->next_move[i] <= tick) {
+            unscheduleCar(board, i);
+            wheel->due[num_due++] = i;
+        }
+        i = next;
+    }
+
+    // deciding which cars move before any of them does, so the order doesn't matter
+    int num_moving = 0;
+    for (int k = 0; k < num_due; k++) {
+        i = wheel->due[k];
+        if (carWaits(board, i, frog)) {
+            scheduleCar(board, i); // it tries again in the next step
+        }
+        else {
+            wheel->due[num_moving++] = i;
+        }
+    }
+
+    int riding = -1; // the car that is carrying the frog
+    if (frog->on_friendly_car && frog->friendly_car_index >= 0 && frog->friendly_car_index < cars->count
+        && cars->active[frog->friendly_car_index]) {
+        riding = frog->friendly_car_index;
+    }
+    int num_off = 0; // the roads whose car in front drove off the board
+    for (int k = 0; k < num_moving; k++) {
+        i = wheel->due[k];
+        int road = i / cars->per_road;
+        uint64_t* bits = carBits(&board->occupancy, road);
+        clearBit(bits, cars->y[i]);
+        cars->y[i] += cars->direction[i];
+        cars->next_move[i] = int(tick) + cars->move_interval[i];
+        if (i == riding) {
+            frog->y += cars->direction[i];
+        }
+        if (cars->y[i] >= 0 && cars->y[i] < width) {
+            setBit(bits, cars->y[i]);
+            scheduleCar(board, i);
+            scheduleSpawn(board, road, tick); // the car may have made room at the entry
+        }
+        else {
+            wheel->due[num_off++] = road; // the slot of this car isn't needed anymore
+        }
+    }
+
+    // the roads are dealt with in their order, so the random numbers are drawn in the same order every time
+    for (int k = 1; k < num_off; k++) {
+        int road = wheel->due[k];
+        int j = k;
+        while (j > 0 && wheel->due[j - 1] > road) {
+            wheel->due[j] = wheel->due[j - 1];
+            j--;
+        }
+        wheel->due[j] = road;
+    }
+    for (int k = 0; k < num_off; k++) {
+        leaveRoad(board, frog, wheel->due[k], riding, tick);
+    }
+    spawnCars(board, num_spawning, tick);
+}
+
+// Function to randomly change the speed of the cars during the game
+void updateCarsSpeed(Board* board) {
+    for (int i = 0; i < board->cars.count; i++) {
+        if (!board->cars.active[i]) {
+            continue;
+        }
+        int change_speed = randomInt(board, 2); // 50% chance to change the speed
+        if (change_speed) {
+            setCarSpeed(board, i, board->car_min_speed + randomInt(board, board->car_max_speed - board->car_min_speed + 1));
+        }
+    }
+}
+
+//**************************
+//* FROG RELATED FUNCTIONS *
+//**************************
+
+// Function to initialize the frog
+void initObject(Object* frog, int x, int y, char symbol, int speed, double now) {
+    frog->x = x;
+    frog->y = y;
+    frog->symbol = symbol;
+    frog->speed = speed;
+    frog->level = 1;
+    frog->last_move_time = now; // Initialize the time of the last move
+    frog->last_key = INPUT_NONE; // Initialize the last clicked key
+    frog->on_friendly_car = false;
+    frog->friendly_car_index = -1;
+    frog->lanes_passed = 0;
+}
+
+// Function to move the frog up
+void moveUp(Object* frog, const Board* board, double current_time) {
+    if (frog->x > 0) {
+        bool noObstacle = !isObstacle(board, frog->x - 1, frog->y); // checking if there is no obstacle in the row above
+        if (noObstacle) {
+            frog->x--;
+            frog->lanes_passed++;
+            frog->last_key = INPUT_NONE;
+            frog->last_move_time = current_time;
+        }
+    }
+}
+
+// Function to move the frog down
+void moveDown(Object* frog, const Board* board, double current_time) {
+    if (frog->x < board->rows - 1) {
+        bool noObstacle = !isObstacle(board, frog->x + 1, frog->y); // checking if there is no obstacle in the row below
+        if (noObstacle) {
+            frog->x++;
+            frog->lanes_passed--;
+            frog->last_key = INPUT_NONE;
+            frog->last_move_time = current_time;
+        }
+    }
+}
+
+// Function to move the frog left
+void moveLeft(Object* frog, const Board* board, double current_time) {
+    if (frog->y > 0) {
+        bool noObstacle = !isObstacle(board, frog->x, frog->y - 1); // checking if there is no obstacle to the left
+        if (noObstacle) {
+            frog->y--;
+            frog->last_key = INPUT_NONE;
+            frog->last_move_time = current_time;
+        }
+    }
+}
+
+// Function to move the frog right
+void moveRight(Object* frog, const Board* board, double current_time) {
+    if (frog->y < board->cols - 2) {
+        bool noObstacle = !isObstacle(board, frog->x, frog->y + 1); // checking if there is no obstacle to the right
+        if (noObstacle) {
+            frog->y++;
+            frog->last_key = INPUT_NONE;
+            frog->last_move_time = current_time;
+        }
+    }
+}
+
+// Function to move the frog
+void moveObject(Object* frog, int input, const Board* board, double now) {
+    double passed_time = now - frog->last_move_time; // Calulate the last time since last move
+
+    if (input == INPUT_UP || input == INPUT_DOWN || input == INPUT_LEFT || input == INPUT_RIGHT) {
+        frog->last_key = input; // Save the last key pressed
+        frog->on_friendly_car = false;
+    }
+
+    if (passed_time >= 1.0 / frog->speed) { // frog speed delay
+        if (frog->last_key == INPUT_UP) {
+            moveUp(frog, board, now);
+        }
+        else if (frog->last_key == INPUT_DOWN) {
+            moveDown(frog, board, now);
+        }
+        else if (frog->last_key == INPUT_LEFT) {
+            moveLeft(frog, board, now);
+        }
+        else if (frog->last_key == INPUT_RIGHT) {
+            moveRight(frog, board, now);
+        }
+    }
+}
+
+//***************************
+//* STORK RELATED FUNCTIONS *
+//***************************
+
+void initStork(Stork* stork, Board* board, const Object* frog, double now) {
+    stork->x = board->rows - 1;
+    stork->y = 0;
+    stork->symbol = 'B';
+    stork->speed = frog->speed / 2;
+    stork->last_move_time = now;
+    setBit(storkBits(&board->occupancy, stork->x), stork->y);
+}
+
+// Function to move the stork to the given cell, keeping its bit in the occupancy
+void moveStork(Board* board, Stork* stork, int x, int y) {
+    clearBit(storkBits(&board->occupancy, stork->x), stork->y);
+    stork->x = x;
+    stork->y = y;
+    setBit(storkBits(&board->occupancy, stork->x), stork->y);
+}
+
+// Function to get the bits of the given row of the board in one of the bitsets of the field
+uint64_t* fieldRow(const DistanceField* field, uint64_t* bits, int x) {
+    return bits + (size_t)(x - field->min_x) * field->words;
+}
+
+// Function to start the field again from the cell of the frog
+void startField(DistanceField* field, int frog_x, int frog_y, const Board* board) {
+    field->frog_x = frog_x;
+    field->frog_y = frog_y;
+    field->min_x = frog_x - field->radius_x > 0 ? frog_x - field->radius_x : 0;
+    field->max_x = frog_x + field->radius_x < board->rows - 1 ? frog_x + field->radius_x : board->rows - 1;
+    field->min_y = frog_y - field->radius_y > 0 ? frog_y - field->radius_y : 0;
+    field->max_y = frog_y + field->radius_y < board->cols - 2 ? frog_y + field->radius_y : board->cols - 2;
+    field->first_word = field->min_y / 64;
+    field->words = field->max_y / 64 - field->first_word + 1;
+    for (int w = 0; w < field->words; w++) {
+        int from = field->min_y - (field->first_word + w) * 64; // the columns of the word are from ... to
+        int to = field->max_y - (field->first_word + w) * 64;
+        uint64_t mask = ~0ULL;
+        if (from > 0) {
+            mask &= ~0ULL << from;
+        }
+        if (to < 63) {
+            mask &= ~0ULL >> (63 - to);
+        }
+        field->masks[w] = mask;
+    }
+    memset(field->visited, 0, (size_t)(field->max_x - field->min_x + 1) * field->words * sizeof(uint64_t));
+    uint64_t* frontier = fieldRow(field, field->frontier, frog_x);
+    memset(frontier, 0, field->words * sizeof(uint64_t));
+    setBit(frontier, frog_y - field->first_word * 64);
+    setBit(fieldRow(field, field->visited, frog_x), frog_y - field->first_word * 64);
+    field->distance[(frog_x - field->min_x) * (2 * field->radius_y + 1) + frog_y - field->min_y] = 0;
+    field->layer = 0;
+    field->frontier_min = frog_x;
+    field->frontier_max = frog_x;
+}
+
+// Function to find the next layer of the field: the cells next to the frontier (diagonally too, the stork flies)
+// that aren't obstacles and weren't found yet, 64 cells at once
+void expandField(DistanceField* field, const Board* board) {
+    int from = field->frontier_min - 1 > field->min_x ? field->frontier_min - 1 : field->min_x;
+    int to = field->frontier_max + 1 < field->max_x ? field->frontier_max + 1 : field->max_x;
+    int width = 2 * field->radius_y + 1;
+    int new_min = field->max_x + 1;
+    int new_max = field->min_x - 1;
+    field->layer++;
+    for (int x = from; x <= to; x++) {
+        for (int w = 0; w < field->words; w++) { // the frontier one row up and down
+            uint64_t bits = 0;
+            for (int r = x - 1; r <= x + 1; r++) {
+                if (r >= field->frontier_min && r <= field->frontier_max) {
+                    bits |= fieldRow(field, field->frontier, r)[w];
+                }
+            }
+            field->around[w] = bits;
+        }
+        uint64_t* out = fieldRow(field, field->next, x);
+        const uint64_t* visited = fieldRow(field, field->visited, x);
+        const uint64_t* obstacles = obstacleBits(board, x) + field->first_word;
+        bool found = false;
+        for (int w = 0; w < field->words; w++) { // and one column left and right
+            uint64_t bits = field->around[w];
+            uint64_t left = w > 0 ? field->around[w - 1] >> 63 : 0;
+            uint64_t right = w + 1 < field->words ? field->around[w + 1] << 63 : 0;
+            bits |= (bits << 1) | left | (bits >> 1) | right;
+            out[w] = bits & ~obstacles[w] & ~visited[w] & field->masks[w];
+            found |= out[w] != 0;
+        }
+        if (!found) {
+            continue;
+        }
+        new_min = x < new_min ? x : new_min;
+        new_max = x;
+        int* distance = field->distance + (x - field->min_x) * width - field->min_y + field->first_word * 64;
+        uint64_t* visited_row = fieldRow(field, field->visited, x);
+        for (int w = 0; w < field->words; w++) {
+            visited_row[w] |= out[w];
+            for (uint64_t bits = out[w]; bits != 0; bits &= bits - 1) {
+                distance[w * 64 + __builtin_ctzll(bits)] = field->layer;
+            }
+        }
+    }
+    uint64_t* swap = field->frontier; // the new layer is the frontier now
+    field->frontier = field->next;
+    field->next = swap;
+    field->frontier_min = new_min;
+    field->frontier_max = new_max;
+}
+
+// Function to start the field again when the frog changed its cell. The field is made again from the frog every
+// time: the layers of the old cell can't be used, a cell may get one step closer or farther and the window moves
+void followFrog(DistanceField* field, const Object* frog, const Board* board) {
+    if (field->frog_x != frog->x || field->frog_y != frog->y) {
+        startField(field, frog->x, frog->y, board);
+    }
+}
+
+// Function to read the distance of a cell from the field as far as it was made, -1 if the field doesn't cover
+// the cell or didn't find it
+int fieldDistance(const DistanceField* field, int x, int y) {
+    if (x < field->min_x || x > field->max_x || y < field->min_y || y > field->max_y
+        || !testBit(fieldRow(field, field->visited, x), y - field->first_word * 64)) {
+        return -1;
+    }
+    return field->distance[(x - field->min_x) * (2 * field->radius_y + 1) + y - field->min_y];
+}
+
+// Function to get the number of moves from the cell to the frog around the obstacles, -1 if the field doesn't
+// cover the cell or the frog can't be reached from it. The search only goes as far as the farthest cell that
+// was asked for
+int storkDistance(Board* board, const Object* frog, int x, int y) {
+    DistanceField* field = &board->stork_field;
+    followFrog(field, frog, board);
+    if (x < field->min_x || x > field->max_x || y < field->min_y || y > field->max_y || isObstacle(board, x, y)) {
+        return -1;
+    }
+    const uint64_t* visited = fieldRow(field, field->visited, x);
+    int bit = y - field->first_word * 64;
+    while (!testBit(visited, bit) && field->frontier_min <= field->frontier_max) {
+        expandField(field, board);
+    }
+    return fieldDistance(field, x, y);
+}
+
+// Function to make the field reach the cell and the 8 cells around it, the ones that the stork can move to
+const DistanceField* fieldAround(Board* board, const Object* frog, int x, int y) {
+    DistanceField* field = &board->stork_field;
+    followFrog(field, frog, board);
+    int from_x = x - 1 > field->min_x ? x - 1 : field->min_x;
+    int to_x = x + 1 < field->max_x ? x + 1 : field->max_x;
+    int from_y = y - 1 > field->min_y ? y - 1 : field->min_y;
+    int to_y = y + 1 < field->max_y ? y + 1 : field->max_y;
+    for (int r = from_x; r <= to_x; r++) {
+        const uint64_t* visited = fieldRow(field, field->visited, r);
+        for (int c = from_y; c <= to_y; c++) {
+            while (!isObstacle(board, r, c) && !testBit(visited, c - field->first_word * 64)
+                && field->frontier_min <= field->frontier_max) {
+                expandField(field, board);
+            }
+        }
+    }
+    return field;
+}
+
+// Function to move the stork one cell closer to the frog: around the obstacles when it is near the frog,
+// straight towards it when it is far away
+void updateStork(Stork* stork, Object* frog, Board* board, double now) {
+    double passed_time = now - stork->last_move_time;
+    if (passed_time >= 1.0 / stork->speed) {
+        int x = stork->x;
+        int y = stork->y;
+        if (y < frog->y) {
+            y++;
+        }
+        else if (y > frog->y) {
+            y--;
+        }
+        if (x > frog->x) {
+            x--;
+        }
+        else if (x < frog->x) {
+            x++;
+        }
+        const DistanceField* field = fieldAround(board, frog, stork->x, stork->y); // every move of the stork is in it now
+        int best = fieldDistance(field, x, y); // the straight move wins if nothing is better
+        for (int dx = -1; dx <= 1; dx++) {
+            for (int dy = -1; dy <= 1; dy++) {
+                int nx = stork->x + dx;
+                int ny = stork->y + dy;
+                int distance = fieldDistance(field, nx, ny); // -1 outside of the board too, the field is in it
+                if (distance >= 0 && (best < 0 || distance < best)) {
+                    best = distance;
+                    x = nx;
+                    y = ny;
+                }
+            }
+        }
+        moveStork(board, stork, x, y);
+        stork->last_move_time = now;
+    }
+}
+
+//*********************************
+//* GAME CURRENT STATUS FUNCTIONS *
+//*********************************
+
+// Function to check if the frog collided with a car or a stork
+bool checkCollision(Object* frog, Board* board) {
+    //checking a collision with the car
+    int i = carAt(board, frog->x, frog->y);
+    if (i >= 0) {
+        if (board->cars.symbol[i] == 'F' && board->friendly_on) {
+            frog->on_friendly_car = true;
+            frog->friendly_car_index = i;
+            return false;
+        }
+        else {
+            return true;
+        }
+    }
+    //checking a collsion with the stork
+    if (testBit(storkBits(&board->occupancy, frog->x), frog->y)) {
+        return true;
+    }
+    return false;
+}
+
+// Function to check if the frog reached the end
+bool checkWin(const Object* frog) {
+    return frog->x == 0;
+}
+
+//************************
+//* GAME SCORE FUNCTIONS *
+//************************
+
+// Function that calculate points after the end of the game
+int CalculatePoints(const Object* frog, const Timer* timer) {
+    int lanes_passed = frog->lanes_passed;
+    double time_passed = timer->current_time;
+    int win = checkWin(frog);
+    int bonus_for_win = (1 + win);
+    int minus_for_speed = 30 * frog->speed;
+    int points = 0;
+    points += (lanes_passed * 60 - 3 * time_passed) * bonus_for_win;
+    points -= minus_for_speed;
+    if (points < 0) {
+        points = 0;
+    }
+    return points;
+}
+
+//************************************
+//* READ PARAMETERS FROM CONFIG FILE *
+//************************************
+
+void openConfigFile(int* FROG_SPEED, int* CAR_MIN_SPEED, int* CAR_MAX_SPEED, int* TICK_RATE, int* BOARD_ROWS, int* BOARD_COLS, int* CARS_PER_ROAD) {
+    FILE* configFile = fopen("config.txt", "r");
+    if (configFile == NULL) {
+        printf("Error: config.txt file not found!\n");
+        return;
+    }
+    char key[30];
+    int value;
+    for (int i = 0; i < 7; i++) {
+        if (fscanf(configFile, "%29s%d\n", key, &value) == 2) {
+            if (i == 0) {
+                *FROG_SPEED = value;
+            }
+            else if (i == 1) {
+                *CAR_MIN_SPEED = value;
+            }
+            else if (i == 2) {
+                *CAR_MAX_SPEED = value;
+            }
+            else if (i == 3) {
+                *TICK_RATE = value;
+            }
+            else if (i == 4) {
+                *BOARD_ROWS = value;
+            }
+            else if (i == 5) {
+                *BOARD_COLS = value;
+            }
+            else {
+                *CARS_PER_ROAD = value;
+            }
+        }
+    }
+    fclose(configFile);
+}
+
+//***********************
+//* GAME STEP FUNCTIONS *
+//***********************
+
+// Function to get the seed of the random numbers of the given level, every level has its own seed so the next
+// level can be made before the current one ends. The first level uses the seed of the game
+unsigned long long levelSeed(unsigned long long seed, int level) {
+    return seed + (unsigned long long)(level - 1) * 0x9E3779B97F4A7C15ULL;
+}
+
+// Function to make the given level of the game on the board, it starts in the step 0 and is moved to the step
+// in which it is played by startLevel. The arena of the board has to fit boardMemorySize
+void generateLevel(Board* board, const GameConfig* config, int level) {
+    int faster = 3 * (level - 1); // the cars are faster in every level
+    seedRandom(board, levelSeed(config->seed, level));
+    initBoard(board, config->rows, config->cols, config->car_min_speed + faster, config->car_max_speed + faster,
+        config->tick_rate, 0, 0, config->cars_per_road, config->frog_speed);
+}
+
+// Function to make room for a game with the given parameters, it is started with restartGame
+void allocateGame(Game* game, const GameConfig* config) {
+    game->config = *config;
+    if (game->config.tick_rate <= 0) {
+        game->config.tick_rate = DEFAULT_TICK_RATE;
+    }
+    game->recording = NULL;
+    game->profiler = NULL;
+    game->board = new Board;
+    initArena(&game->board->arena, boardMemorySize(config->rows, config->cols, config->cars_per_road));
+    game->pipeline = new LevelPipeline;
+    initPipeline(game->pipeline, &game->config);
+    game->frog = new Object;
+    game->stork = new Stork;
+    game->timer = new Timer;
+}
+
+// Function to start a new game with the given seed in the memory of the game, nothing is allocated, so the
+// batches of games (env.h) can start thousands of them cheaply
+void restartGame(Game* game, unsigned long long seed) {
+    game->config.seed = seed;
+    game->tick = 0;
+    game->now = 0.0;
+    game->status = GAME_RUNNING;
+
+    generateLevel(game->board, &game->config, 1);
+    resetPipeline(game->pipeline, &game->config);
+    prepareLevel(game->pipeline, 2);
+
+    initObject(game->frog, game->board->rows - 1, game->board->cols / 2, 'O', game->config.frog_speed, game->now);
+    initStork(game->stork, game->board, game->frog, game->now);
+    initTimer(game->timer, game->now);
+}
+
+// Function to start a new game with the given parameters
+void initGame(Game* game, const GameConfig* config) {
+    allocateGame(game, config);
+    restartGame(game, config->seed);
+}
+
+// Function to move on to the next level with faster cars, the level is already made
+void nextLevel(Game* game) {
+    Board* board = takeLevel(game->pipeline, game->board);
+    game->board = board;
+    startLevel(board, game->tick);
+    game->frog->level++;
+    game->frog->x = board->rows - 1;
+    game->frog->y = board->cols / 2;
+    game->stork->x = board->rows - 1; // the new board has no stork yet
+    game->stork->y = 0;
+    setBit(storkBits(&board->occupancy, game->stork->x), game->stork->y);
+    prepareLevel(game->pipeline, game->frog->level + 1);
+}
+
+// Function to simulate one step (1 / tick_rate seconds) of the game
+int step(Game* game, int input) {
+    if (game->status == GAME_OVER || game->status == GAME_WON) {
+        return game->status;
+    }
+    game->tick++;
+    game->now = double(game->tick) / game->config.tick_rate;
+    if (game->recording != NULL && input != INPUT_NONE) {
+        recordInput(game->recording, game->tick, input);
+    }
+
+    Board* board = game->board;
+    Object* frog = game->frog;
+    Stork* stork = game->stork;
+    Timer* timer = game->timer;
+
+    Profiler* profiler = game->profiler;
+    long long time = profileStart(profiler);
+    updateTimer(timer, game->now);
+    time = profilePhase(profiler, PHASE_TIMER, time);
+    updateCars(board, frog, game->tick);
+    time = profilePhase(profiler, PHASE_CARS, time);
+    moveObject(frog, input, board, game->now);
+    time = profilePhase(profiler, PHASE_FROG, time);
+    updateStork(stork, frog, board, game->now);
+    time = profilePhase(profiler, PHASE_STORK, time);
+    if (int(timer->current_time) / 10 > timer->speed_changes) { // changing the car speeds every 10 seconds
+        timer->speed_changes++;
+        updateCarsSpeed(board);
+        profilePhase(profiler, PHASE_SPEED, time);
+    }
+    if (input == INPUT_FRIENDLY) {
+        FriendlyOnOff(board);
+    }
+    if (checkCollision(frog, board)) {
+        game->status = GAME_OVER;
+    }
+    else if (checkWin(frog)) {
+        if (frog->level == LAST_LEVEL) {
+            game->status = GAME_WON;
+        }
+        else {
+            nextLevel(game);
+            return GAME_LEVEL_UP;
+        }
+    }
+    return game->status;
+}
+
+// Function to find the first step in which at least delay seconds passed since time, checked the same way as
+// the engine checks it, so the result is exact
+long long firstStepAfter(double time, double delay, int tick_rate) {
+    long long t = (long long)ceil((time + delay) * tick_rate) - 1;
+    if (t < 0) {
+        t = 0;
+    }
+    while (double(t) / tick_rate - time < delay) {
+        t++;
+    }
+    while (t > 0 && double(t - 1) / tick_rate - time >= delay) {
+        t--;
+    }
+    return t;
+}
+
+// Function to find the next step in which a car moves or a new car comes, the slots of the wheel are looked at in order
+long long nextCarMove(const Board* board) {
+    const TimingWheel* wheel = &board->wheel;
+    long long next = LLONG_MAX; // the first entry of the later rounds, if no slot has one that is due
+    for (long long t = wheel->tick + 1; t <= wheel->tick + WHEEL_SLOTS; t++) {
+        for (int i = wheel->head[t & (WHEEL_SLOTS - 1)]; i >= 0; i = wheel->next[i]) {
+            long long when = i < board->cars.count ? board->cars.next_move[i] : board->roads[i - board->cars.count].next_spawn;
+            if (when <= t) {
+                return t;
+            }
+            if (when < next) {
+                next = when;
+            }
+        }
+    }
+    return next;
+}
+
+// Function to find the next step in which something happens without an input: a car, the frog (going on
+// with the last key) or the stork moves, or the car speeds change. Until then the steps don't change anything,
+// so the game can sleep that long
+long long nextEventTick(const Game* game) {
+    int tick_rate = game->config.tick_rate;
+    long long next = nextCarMove(game->board);
+    if (game->frog->last_key != INPUT_NONE && game->frog->speed > 0) {
+        long long frog_move = firstStepAfter(game->frog->last_move_time, 1.0 / game->frog->speed, tick_rate);
+        next = frog_move < next ? frog_move : next;
+    }
+    if (game->stork->speed > 0) {
+        long long stork_move = firstStepAfter(game->stork->last_move_time, 1.0 / game->stork->speed, tick_rate);
+        next = stork_move < next ? stork_move : next;
+    }
+    long long speed_change = firstStepAfter(game->timer->start_time, 10.0 * (game->timer->speed_changes + 1), tick_rate);
+    next = speed_change < next ? speed_change : next;
+    return next > game->tick ? next : game->tick + 1;
+}
+
+// Function to free everything that initGame allocated
+void freeGame(Game* game) {
+    freePipeline(game->pipeline);
+    delete game->pipeline;
+    game->pipeline = NULL;
+    freeMemory(game->board, game->frog, game->timer, game->stork);
+    game->board = NULL;
+    game->frog = NULL;
+    game->timer = NULL;
+    game->stork = NULL;
+}
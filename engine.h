@@ -0,0 +1,332 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - simulation engine
+    Version: 1.0
+*/
+
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include <stdint.h>
+#include "arena.h"
+
+//**********************
+//* DEFINING CONSTANTS *
+//**********************
+
+#define MINIMUM(rows) ((rows) / 2) // DEFINING MINIMUM AND MAXIMUM NUMBER OF ROADS
+#define MAXIMUM(rows) ((rows) - 2)
+
+#define DEFAULT_TICK_RATE 100 // SIMULATION STEPS PER SECOND
+#define CAR_SPACING 2 // A CAR NEVER GETS CLOSER THAN THIS TO THE CAR IN FRONT OF IT
+#define CAR_SPAWN_RATE 2 // NEW CARS PER SECOND ON A ROAD THAT ISN'T FULL
+#define WHEEL_SLOTS 256 // SLOTS OF THE TIMING WHEEL OF THE CARS, A POWER OF 2
+#define STORK_FIELD_RADIUS 64 // THE STORK FINDS ITS WAY AROUND THE OBSTACLES THIS CLOSE TO THE FROG
+#define LAST_LEVEL 3
+#define LEVEL_TRIES 10 // A LEVEL THAT CAN'T BE WON IS MADE AGAIN AT MOST THIS MANY TIMES
+#define RANDOM_PLAY_STREAM 0 // THE RANDOM NUMBERS OF A LEVEL WHILE IT IS PLAYED
+#define RANDOM_LEVEL_STREAM 1 // TRY t OF MAKING A LEVEL TAKES ITS NUMBERS FROM THE STREAM RANDOM_LEVEL_STREAM + t
+#define RANDOM_SPAWN_STREAM (RANDOM_LEVEL_STREAM + LEVEL_TRIES) // ONE NUMBER FOR EVERY ROAD AND STEP, IT DECIDES IF A NEW CAR COMES
+#define SPAWN_LOOKAHEAD 4096 // THE NEXT NEW CAR OF A ROAD IS LOOKED FOR AT MOST THIS MANY STEPS AHEAD, THEN THE ROAD LOOKS AGAIN
+
+#define INPUT_NONE 0 // INPUTS ACCEPTED BY step()
+#define INPUT_UP 1
+#define INPUT_DOWN 2
+#define INPUT_LEFT 3
+#define INPUT_RIGHT 4
+#define INPUT_FRIENDLY 5 // TURN THE FRIENDLY CARS ON/OFF
+
+#define GAME_RUNNING 0 // RESULTS RETURNED BY step()
+#define GAME_OVER 1
+#define GAME_WON 2
+#define GAME_LEVEL_UP 3
+
+//***********************
+//* DEFINING STRUCTURES *
+//***********************
+
+struct CarStore { // The cars, every field in its own array so updateCars reads them one after another
+    int count; // Number of slots, the road r has the slots r * per_road ... r * per_road + per_road - 1
+    int per_road; // Most cars on one road
+    int* x; // Car's row
+    int* y; // Car's position in the row
+    int* direction; // -1 for left, 1 for right
+    int* speed;
+    int* move_interval; // Number of steps between two moves, follows from the speed
+    int* next_move; // Step in which the car moves next time
+    int* stopping; // 1 for the cars that stop in front of the frog ('S')
+    int* active; // 1 for the slots that have a car
+    char* symbol;
+};
+
+struct Occupancy { // Which cells are taken, one bit per cell, so a collision is a single lookup
+    int words; // Number of 64-bit words in one row of bits
+    int* road_of_row; // Index of the road in the given row, -1 for the rows without a road
+    uint64_t* cars; // One row of bits for every road
+    uint64_t* storks; // One row of bits for every row of the board
+};
+
+struct TimingWheel { // The cars and the new cars of the roads sorted by their step, so a step only looks at what is due
+    long long tick; // The last step that was simulated
+    int* head; // First entry in every slot, -1 for an empty slot. The entry i < cars.count is a car, it waits in the slot
+               // next_move % WHEEL_SLOTS, the entry cars.count + r is the next new car of the road r (next_spawn)
+    int* next; // Next and previous entry in the same slot, -1 for none
+    int* prev;
+    int* slot; // Slot of every entry, -1 for the empty car slots and the roads that don't wait for a new car
+    int* due; // Room for the cars that are due in one step
+    int* spawning; // Room for the roads whose new car is due in one step
+};
+
+struct DistanceField { // Steps from the frog to the cells near it going around the obstacles, shared by the storks
+    int radius_x; // The field covers the cells at most radius_x rows and radius_y columns from the frog
+    int radius_y;
+    int frog_x; // The cell the field was made for, -1 before the first one
+    int frog_y;
+    int min_x; // The cells of the board that the field covers
+    int max_x;
+    int min_y;
+    int max_y;
+    int first_word; // The word of the rows of the board where the bits of the field start
+    int words; // Number of words in one row of the bits of the field
+    int layer; // Distance of the cells in the frontier
+    int frontier_min; // Rows of the frontier, frontier_min > frontier_max when every reachable cell was found
+    int frontier_max;
+    uint64_t* masks; // For every word, the columns that the field covers
+    uint64_t* visited; // One row of bits for every row of the field, set for the cells that were found
+    uint64_t* frontier; // The cells that were found last, the search goes one layer further when it is needed
+    uint64_t* next;
+    uint64_t* around; // Room for one row of the frontier grown by one row up and down
+    int* distance; // For every cell of the field, valid where visited is set
+};
+
+struct RandomStream { // Counter-based random numbers, the n-th one is a hash of the key and n, so any of them can be made at once
+    uint64_t key;
+    uint64_t counter; // Numbers taken so far
+};
+
+struct Road { // The slots of a road are a ring buffer, the cars in it are in the order they drive
+    int x; // Road's row
+    int direction; // -1 for left, 1 for right, the same for every car on the road
+    int first; // Slot (0 ... per_road - 1) of the car in front
+    int count; // Number of cars on the road
+    int next_spawn; // Step in which a new car comes if its entry is still free, -1 while the entry is taken
+};
+
+struct Board {
+    int rows; // Board's size
+    int cols;
+    Arena arena; // Memory for everything below, reused by every level
+    char** grid; // Grid of the board
+    Road* roads; // Array of roads
+    CarStore cars; // Cars on the roads
+    TimingWheel wheel; // When the cars move next
+    DistanceField stork_field; // The way to the frog for the stork
+    Occupancy occupancy; // Cells taken by the cars and the stork
+    int words; // Number of 64-bit words in one row of cells
+    uint64_t* obstacles; // One row of bits for every row of the board, set for the obstacles
+    uint64_t* free_rows; // One bit for every row, set for the rows on which there is no road
+    uint64_t* road_rows; // One bit for every row, set for the rows with a road
+    int num_roads; // Number of roads
+    int car_min_speed; // Minimum and maximum speed of the cars
+    int car_max_speed;
+    int tick_rate; // Steps per second, needed to turn the speeds into move intervals
+    int cars_per_road; // Most cars on one road at once
+    int spaces_count; // The number of spaces clicked in order to decide if the friendly car should be on/off
+    bool friendly_on; // Boolean to check wheter the friednly cars shoudl be on
+    uint64_t random_seed; // Seed of the level, every stream of its random numbers comes from it
+    RandomStream random; // The stream that the random numbers are taken from now
+    uint64_t spawn_key; // Key of RANDOM_SPAWN_STREAM, its numbers don't depend on the other ones so they are known ahead
+};
+
+struct Object { // define the object that is frog
+    int x; // Object's position
+    int y;
+    char symbol;
+    int speed; // Object's speed
+    double last_move_time; // Time of the last move
+    int last_key; // Last key pressed
+    bool on_friendly_car; // Boolean to check wheter the frog is on the friendly car
+    int friendly_car_index; // Index of the friendly car
+    int level; // the level in which the frog is currently in
+    int lanes_passed;
+};
+
+struct Stork { //Creating a stork that will chase the frog
+    int x;
+    int y;
+    char symbol;
+    int speed;
+    double last_move_time;
+};
+
+struct Timer {
+    double start_time;
+    double current_time;
+    int speed_changes; // How many times the car speeds were changed (once every 10 seconds)
+};
+
+struct GameConfig { // Parameters of a single game, normally read from config.txt
+    int frog_speed;
+    int car_min_speed;
+    int car_max_speed;
+    int rows; // Board's size, independent of any terminal
+    int cols;
+    int tick_rate; // Number of simulation steps per second
+    int cars_per_road; // Most cars on one road at once
+    unsigned long long seed; // The same seed and inputs always give the same game
+    bool background_levels; // Make the next level on its own thread while this one is played, the levels are the same
+};
+
+struct Recording; // replay.h
+struct LevelPipeline; // pipeline.h
+struct Profiler; // profiler.h
+
+struct Game { // Everything that is needed to simulate one game
+    GameConfig config;
+    Board* board;
+    Object* frog;
+    Stork* stork;
+    Timer* timer;
+    long long tick; // Number of steps simulated so far
+    double now; // Simulated time in seconds
+    int status;
+    Recording* recording; // The inputs are written here, NULL if the game isn't recorded
+    LevelPipeline* pipeline; // The next level
+    Profiler* profiler; // The times of the parts of every step are added here, NULL if they aren't measured
+};
+
+//**********************
+//* BITBOARD FUNCTIONS *
+//**********************
+
+inline bool testBit(const uint64_t* bits, int i) {
+    return (bits[i >> 6] >> (i & 63)) & 1;
+}
+
+inline void setBit(uint64_t* bits, int i) {
+    bits[i >> 6] |= uint64_t(1) << (i & 63);
+}
+
+inline void clearBit(uint64_t* bits, int i) {
+    bits[i >> 6] &= ~(uint64_t(1) << (i & 63));
+}
+
+// Bits of the obstacles in the given row
+inline uint64_t* obstacleBits(const Board* board, int row) {
+    return board->obstacles + (long long)row * board->words;
+}
+
+// Checking if there is an obstacle in the given cell
+inline bool isObstacle(const Board* board, int x, int y) {
+    return testBit(obstacleBits(board, x), y);
+}
+
+// Checking if there is no road in the given row (the start and end rows don't count)
+inline bool isFreeRow(const Board* board, int x) {
+    return testBit(board->free_rows, x);
+}
+
+// Bits of the cells taken by the cars on the given road
+inline uint64_t* carBits(const Occupancy* occupancy, int road) {
+    return occupancy->cars + (long long)road * occupancy->words;
+}
+
+// Bits of the cells taken by the storks in the given row
+inline uint64_t* storkBits(const Occupancy* occupancy, int row) {
+    return occupancy->storks + (long long)row * occupancy->words;
+}
+
+// Slot of the j-th car of the road, counted from the car in front
+inline int laneSlot(const Board* board, int road, int j) {
+    int per_road = board->cars.per_road;
+    int k = board->roads[road].first + j;
+    return road * per_road + (k >= per_road ? k - per_road : k);
+}
+
+// Slot of the car in the given cell, -1 if there is none. The bits tell if there is a car,
+// the cars of the road are in the order they drive so the car is found with a binary search
+inline int carAt(const Board* board, int x, int y) {
+    int road = board->occupancy.road_of_row[x];
+    if (road < 0 || !testBit(carBits(&board->occupancy, road), y)) {
+        return -1;
+    }
+    int direction = board->roads[road].direction;
+    int low = 0;
+    int high = board->roads[road].count - 1;
+    while (low < high) { // the first car that isn't in front of the cell
+        int middle = (low + high) / 2;
+        if ((board->cars.y[laneSlot(board, road, middle)] - y) * direction > 0) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+    return laneSlot(board, road, low);
+}
+
+//*************************
+//* RANDOM NUMBER HASHING *
+//*************************
+
+// Mixing the bits of the number (the finalizer of SplitMix64), every bit of the result depends on every bit of it
+inline uint64_t mixBits(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// The counter-th random number of the stream with the given key, nothing has to be drawn before it
+inline uint64_t randomAt(uint64_t key, uint64_t counter) {
+    return mixBits(key + counter * 0x9E3779B97F4A7C15ULL);
+}
+
+//********************
+//* ENGINE FUNCTIONS *
+//********************
+
+uint64_t streamKey(uint64_t seed, uint64_t stream);
+void seedRandom(Board* board, unsigned long long seed);
+void startRandomStream(Board* board, uint64_t stream);
+int randomInt(Board* board, int n);
+
+void initTimer(Timer* timer, double now);
+void updateTimer(Timer* timer, double now);
+
+size_t boardMemorySize(int rows, int cols, int cars_per_road);
+void openCells(const Board* board, int row, uint64_t* out);
+int countOpenCells(const Board* board, int row, int from, int to);
+void reachableColumns(const Board* board, int row, const uint64_t* from, uint64_t* out);
+void findRow(Board* board, int i);
+void startLevel(Board* board, long long tick);
+void initBoard(Board* board, int rows, int cols, int MINSPEED, int MAXSPEED, int tick_rate, long long tick, int roads, int cars_per_road, int frog_speed);
+void FriendlyOnOff(Board* board);
+int moveInterval(int speed, int tick_rate);
+void updateCars(Board* board, Object* frog, long long tick);
+void updateCarsSpeed(Board* board);
+
+void initObject(Object* frog, int x, int y, char symbol, int speed, double now);
+void moveObject(Object* frog, int input, const Board* board, double now);
+
+void initStork(Stork* stork, Board* board, const Object* frog, double now);
+void moveStork(Board* board, Stork* stork, int x, int y);
+int storkDistance(Board* board, const Object* frog, int x, int y);
+void updateStork(Stork* stork, Object* frog, Board* board, double now);
+
+bool checkCollision(Object* frog, Board* board);
+bool checkWin(const Object* frog);
+int CalculatePoints(const Object* frog, const Timer* timer);
+
+void openConfigFile(int* FROG_SPEED, int* CAR_MIN_SPEED, int* CAR_MAX_SPEED, int* TICK_RATE, int* BOARD_ROWS, int* BOARD_COLS, int* CARS_PER_ROAD);
+
+unsigned long long levelSeed(unsigned long long seed, int level);
+void generateLevel(Board* board, const GameConfig* config, int level);
+void allocateGame(Game* game, const GameConfig* config);
+void restartGame(Game* game, unsigned long long seed);
+void initGame(Game* game, const GameConfig* config);
+int step(Game* game, int input);
+long long nextEventTick(const Game* game);
+void freeMemory(Board* board, Object* frog, Timer* timer, Stork* stork);
+void freeGame(Game* game);
+
+#endif
@@ -0,0 +1,395 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - batch of games for training bots
+    Version: 1.0
+
+    Steps many independent games together: one call gives an action to every
+    game and makes ticks_per_step steps of the engine in each of them, the
+    games are split into chunks of ENV_CHUNK that the threads take one after
+    another, so a thread that gets the slow games (a new level is made) doesn't
+    keep the others waiting. The results are written into arrays that have
+    the games one after another, the same arrays every call, so a bot can read
+    them without copying. A game that ended is started again in the next call
+    with the next seed of its slot and the action for it is ignored. The
+    results only depend on the seed, not on the number of threads.
+*/
+
+#include <string.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "engine.h"
+#include "env.h"
+
+//**********************
+//* DEFINING CONSTANTS *
+//**********************
+
+#define ENV_CHUNK 64 // GAMES THAT A THREAD TAKES AT ONCE
+#define ENV_DEFAULT_COUNT 1024
+#define ENV_DEFAULT_TICKS_PER_STEP 10 // A STEP IS 0.1 S OF THE GAME AT 100 TICKS PER SECOND
+#define ENV_DEFAULT_MAX_STEPS 3000 // 5 MINUTES
+#define ENV_DEFAULT_VIEW_ROWS 11
+#define ENV_DEFAULT_VIEW_COLS 21
+
+#define ENV_TASK_RESET 0 // WHAT THE THREADS DO WITH THEIR CHUNKS
+#define ENV_TASK_STEP 1
+
+// The input of the engine for every ENV_ACTION_*
+const int ACTION_INPUTS[ENV_ACTIONS] = { INPUT_NONE, INPUT_UP, INPUT_DOWN, INPUT_LEFT, INPUT_RIGHT, INPUT_FRIENDLY };
+
+//***********************
+//* DEFINING STRUCTURES *
+//***********************
+
+struct BatchEnv {
+    EnvConfig config;
+    EnvArrays arrays;
+    Game* games;
+    long long* episodes; // Games played in every slot, with the seed they give the seed of the next game
+    int* steps; // Steps of the game in every slot
+    uint64_t seed;
+    const int32_t* actions; // Of the call that is worked on
+    int task;
+    std::atomic<int> next_chunk;
+    int num_threads;
+    std::thread* workers; // All the threads but the one that calls
+    std::mutex lock;
+    std::condition_variable wake; // A new call started
+    std::condition_variable finished; // The last worker finished its chunks
+    long long generation; // Number of the call, the workers wait for it to change
+    int working; // Workers that haven't finished the call yet
+    bool stopping;
+};
+
+//**********************
+//* OBSERVING ONE GAME *
+//**********************
+
+int carCode(const Board* board, int car) {
+    if (board->cars.symbol[car] == 'F') {
+        return board->friendly_on ? ENV_CELL_FRIENDLY_CAR_ON : ENV_CELL_FRIENDLY_CAR;
+    }
+    return board->cars.symbol[car] == 'S' ? ENV_CELL_STOPPING_CAR : ENV_CELL_CAR;
+}
+
+// Bits of the word w that are in the columns from ... to
+inline uint64_t columnMask(int w, int from, int to) {
+    int low = from > w * 64 ? from - w * 64 : 0;
+    int high = to < w * 64 + 63 ? to - w * 64 : 63;
+    uint64_t mask = high == 63 ? ~uint64_t(0) : (uint64_t(1) << (high + 1)) - 1;
+    return mask & ~((uint64_t(1) << low) - 1);
+}
+
+// Function to write one row of the cells around the frog, the obstacles come from their bits and the cars
+// from the list of their road, so no cell is looked up on its own
+void observeRow(const Board* board, int x, int left, int width, uint8_t* out) {
+    if (x < 0 || x >= board->rows) {
+        memset(out, ENV_CELL_OUTSIDE, width);
+        return;
+    }
+    int from = left > 0 ? left : 0; // the columns of the board in the view
+    int to = left + width - 1 < board->cols - 2 ? left + width - 1 : board->cols - 2;
+    memset(out, ENV_CELL_OUTSIDE, width);
+    if (from > to) {
+        return;
+    }
+    memset(out + from - left, ENV_CELL_EMPTY, to - from + 1);
+    const uint64_t* obstacles = obstacleBits(board, x);
+    for (int w = from >> 6; w <= to >> 6; w++) {
+        uint64_t bits = obstacles[w] & columnMask(w, from, to);
+        while (bits != 0) {
+            out[w * 64 + __builtin_ctzll(bits) - left] = ENV_CELL_OBSTACLE;
+            bits &= bits - 1;
+        }
+    }
+    int road = board->occupancy.road_of_row[x];
+    if (road >= 0) {
+        for (int j = 0; j < board->roads[road].count; j++) {
+            int slot = laneSlot(board, road, j);
+            int y = board->cars.y[slot];
+            if (y >= from && y <= to) {
+                out[y - left] = (uint8_t)carCode(board, slot);
+            }
+        }
+    }
+}
+
+// Function to write what a bot sees of the game in the given slot
+void observeGame(BatchEnv* env, int i) {
+    const Game* game = &env->games[i];
+    const Board* board = game->board;
+    EnvArrays* arrays = &env->arrays;
+    int top = game->frog->x - arrays->view_rows / 2;
+    int left = game->frog->y - arrays->view_cols / 2;
+    uint8_t* view = arrays->observations + (size_t)i * arrays->view_rows * arrays->view_cols;
+    for (int r = 0; r < arrays->view_rows; r++) {
+        observeRow(board, top + r, left, arrays->view_cols, view + r * arrays->view_cols);
+    }
+    int stork_row = game->stork->x - top;
+    int stork_col = game->stork->y - left;
+    if (stork_row >= 0 && stork_row < arrays->view_rows && stork_col >= 0 && stork_col < arrays->view_cols) {
+        view[stork_row * arrays->view_cols + stork_col] = ENV_CELL_STORK;
+    }
+    arrays->frogs[2 * i] = game->frog->x;
+    arrays->frogs[2 * i + 1] = game->frog->y;
+    arrays->storks[2 * i] = game->stork->x;
+    arrays->storks[2 * i + 1] = game->stork->y;
+
+    int32_t* car = arrays->cars + (size_t)i * arrays->car_slots * ENV_CAR_FIELDS;
+    int n = 0;
+    for (int road = 0; road < board->num_roads; road++) {
+        for (int j = 0; j < board->roads[road].count && n < arrays->car_slots; j++, n++) {
+            int slot = laneSlot(board, road, j);
+            car[0] = board->cars.x[slot];
+            car[1] = board->cars.y[slot];
+            car[2] = board->cars.direction[slot];
+            car[3] = board->cars.speed[slot];
+            car[4] = carCode(board, slot);
+            car += ENV_CAR_FIELDS;
+        }
+    }
+    for (; n < arrays->car_slots; n++) {
+        car[0] = -1;
+        car[1] = car[2] = car[3] = car[4] = 0;
+        car += ENV_CAR_FIELDS;
+    }
+    arrays->points[i] = CalculatePoints(game->frog, game->timer);
+    arrays->levels[i] = game->frog->level;
+}
+
+//********************
+//* PLAYING ONE GAME *
+//********************
+
+// Function to start the next game in the slot, every slot has its own row of seeds. The game is played in the
+// memory the slot got in createBatchEnv
+void startGame(BatchEnv* env, int i) {
+    restartGame(&env->games[i], randomAt(randomAt(env->seed, (uint64_t)i), (uint64_t)env->episodes[i]));
+    env->episodes[i]++;
+    env->steps[i] = 0;
+    env->arrays.rewards[i] = 0.0f;
+    env->arrays.dones[i] = ENV_RUNNING;
+    observeGame(env, i);
+}
+
+// Function to give the action to the game and simulate one step of it, a game that ended starts again
+void stepGame(BatchEnv* env, int i, int action) {
+    if (env->arrays.dones[i] != ENV_RUNNING) {
+        startGame(env, i);
+        return;
+    }
+    Game* game = &env->games[i];
+    int input = action >= 0 && action < ENV_ACTIONS ? ACTION_INPUTS[action] : INPUT_NONE;
+    int points = env->arrays.points[i];
+    for (int t = 0; t < env->config.ticks_per_step && game->status == GAME_RUNNING; t++) {
+        step(game, t == 0 ? input : INPUT_NONE);
+    }
+    env->steps[i]++;
+    observeGame(env, i);
+    env->arrays.rewards[i] = float(env->arrays.points[i] - points);
+    if (game->status != GAME_RUNNING) {
+        env->arrays.dones[i] = ENV_TERMINATED;
+    }
+    else if (env->config.max_steps > 0 && env->steps[i] >= env->config.max_steps) {
+        env->arrays.dones[i] = ENV_TRUNCATED;
+    }
+}
+
+//***********
+//* THREADS *
+//***********
+
+// Function to take the chunks of games until none is left, every thread of the call runs it
+void runChunks(BatchEnv* env) {
+    int count = env->config.count;
+    int chunks = (count + ENV_CHUNK - 1) / ENV_CHUNK;
+    while (true) {
+        int chunk = env->next_chunk.fetch_add(1);
+        if (chunk >= chunks) {
+            return;
+        }
+        int end = (chunk + 1) * ENV_CHUNK < count ? (chunk + 1) * ENV_CHUNK : count;
+        for (int i = chunk * ENV_CHUNK; i < end; i++) {
+            if (env->task == ENV_TASK_RESET) {
+                startGame(env, i);
+            }
+            else {
+                stepGame(env, i, env->actions[i]);
+            }
+        }
+    }
+}
+
+void workerThread(BatchEnv* env) {
+    long long seen = 0;
+    std::unique_lock<std::mutex> guard(env->lock);
+    while (true) {
+        while (env->generation == seen && !env->stopping) {
+            env->wake.wait(guard);
+        }
+        if (env->stopping) {
+            return;
+        }
+        seen = env->generation;
+        guard.unlock();
+        runChunks(env);
+        guard.lock();
+        env->working--;
+        if (env->working == 0) {
+            env->finished.notify_one();
+        }
+    }
+}
+
+// Function to do the task with every game, the calling thread works too and returns when all the games are done
+void runTask(BatchEnv* env, int task) {
+    env->task = task;
+    env->next_chunk = 0;
+    if (env->num_threads > 1) {
+        std::lock_guard<std::mutex> guard(env->lock);
+        env->working = env->num_threads - 1;
+        env->generation++;
+    }
+    env->wake.notify_all();
+    runChunks(env);
+    std::unique_lock<std::mutex> guard(env->lock);
+    while (env->working > 0) {
+        env->finished.wait(guard);
+    }
+}
+
+//*****************
+//* ENV FUNCTIONS *
+//*****************
+
+void defaultEnvConfig(EnvConfig* config) {
+    config->count = ENV_DEFAULT_COUNT;
+    config->threads = 0;
+    config->rows = 26; // the size of the board on a 40x200 terminal and the values of the default config.txt
+    config->cols = 50;
+    config->frog_speed = 3;
+    config->car_min_speed = 1;
+    config->car_max_speed = 5;
+    config->tick_rate = DEFAULT_TICK_RATE;
+    config->cars_per_road = 1;
+    config->ticks_per_step = ENV_DEFAULT_TICKS_PER_STEP;
+    config->max_steps = ENV_DEFAULT_MAX_STEPS;
+    config->view_rows = ENV_DEFAULT_VIEW_ROWS;
+    config->view_cols = ENV_DEFAULT_VIEW_COLS;
+}
+
+// Function to make the games and the arrays, the games start with resetBatchEnv. Returns NULL for a wrong config
+BatchEnv* createBatchEnv(const EnvConfig* config) {
+    if (config->count < 1 || config->rows < 4 || config->cols < 3 || config->view_rows < 1 || config->view_cols < 1) {
+        return NULL;
+    }
+    if (config->frog_speed < 1 || config->car_min_speed < 1 || config->car_max_speed < config->car_min_speed) {
+        return NULL; // the speeds of the cars are drawn from min ... max
+    }
+    BatchEnv* env = new BatchEnv;
+    env->config = *config;
+    if (env->config.tick_rate <= 0) {
+        env->config.tick_rate = DEFAULT_TICK_RATE;
+    }
+    if (env->config.cars_per_road < 1) {
+        env->config.cars_per_road = 1;
+    }
+    if (env->config.ticks_per_step < 1) {
+        env->config.ticks_per_step = 1;
+    }
+    int count = env->config.count;
+    EnvArrays* arrays = &env->arrays;
+    arrays->count = count;
+    arrays->view_rows = env->config.view_rows;
+    arrays->view_cols = env->config.view_cols;
+    arrays->car_slots = MAXIMUM(env->config.rows) * env->config.cars_per_road;
+    arrays->observations = new uint8_t[(size_t)count * arrays->view_rows * arrays->view_cols];
+    arrays->frogs = new int32_t[2 * (size_t)count];
+    arrays->storks = new int32_t[2 * (size_t)count];
+    arrays->cars = new int32_t[(size_t)count * arrays->car_slots * ENV_CAR_FIELDS];
+    arrays->rewards = new float[count];
+    arrays->dones = new uint8_t[count];
+    arrays->points = new int32_t[count];
+    arrays->levels = new int32_t[count];
+
+    GameConfig game_config;
+    game_config.frog_speed = env->config.frog_speed;
+    game_config.car_min_speed = env->config.car_min_speed;
+    game_config.car_max_speed = env->config.car_max_speed;
+    game_config.rows = env->config.rows;
+    game_config.cols = env->config.cols;
+    game_config.tick_rate = env->config.tick_rate;
+    game_config.cars_per_road = env->config.cars_per_road;
+    game_config.seed = 0;
+    game_config.background_levels = false; // the threads are already busy with the other games
+    env->games = new Game[count];
+    env->episodes = new long long[count];
+    env->steps = new int[count];
+    for (int i = 0; i < count; i++) {
+        allocateGame(&env->games[i], &game_config); // not started yet, a step without a reset starts it
+        env->episodes[i] = 0;
+        arrays->dones[i] = ENV_TERMINATED;
+    }
+    env->seed = 0;
+    env->actions = NULL;
+
+    int threads = env->config.threads > 0 ? env->config.threads : (int)std::thread::hardware_concurrency();
+    int chunks = (count + ENV_CHUNK - 1) / ENV_CHUNK;
+    env->num_threads = threads < 1 ? 1 : (threads > chunks ? chunks : threads);
+    env->generation = 0;
+    env->working = 0;
+    env->stopping = false;
+    env->workers = new std::thread[env->num_threads - 1];
+    for (int i = 0; i < env->num_threads - 1; i++) {
+        env->workers[i] = std::thread(workerThread, env);
+    }
+    return env;
+}
+
+// Function to start every game again, the games of the same seed are always the same
+const EnvArrays* resetBatchEnv(BatchEnv* env, uint64_t seed) {
+    env->seed = seed;
+    for (int i = 0; i < env->config.count; i++) {
+        env->episodes[i] = 0;
+    }
+    runTask(env, ENV_TASK_RESET);
+    return &env->arrays;
+}
+
+// Function to give every game its action (ENV_ACTION_*) and simulate one step of all of them
+const EnvArrays* stepBatchEnv(BatchEnv* env, const int32_t* actions) {
+    env->actions = actions;
+    runTask(env, ENV_TASK_STEP);
+    env->actions = NULL;
+    return &env->arrays;
+}
+
+void freeBatchEnv(BatchEnv* env) {
+    {
+        std::lock_guard<std::mutex> guard(env->lock);
+        env->stopping = true;
+    }
+    env->wake.notify_all();
+    for (int i = 0; i < env->num_threads - 1; i++) {
+        env->workers[i].join();
+    }
+    delete[] env->workers;
+    for (int i = 0; i < env->config.count; i++) {
+        freeGame(&env->games[i]);
+    }
+    delete[] env->games;
+    delete[] env->episodes;
+    delete[] env->steps;
+    EnvArrays* arrays = &env->arrays;
+    delete[] arrays->observations;
+    delete[] arrays->frogs;
+    delete[] arrays->storks;
+    delete[] arrays->cars;
+    delete[] arrays->rewards;
+    delete[] arrays->dones;
+    delete[] arrays->points;
+    delete[] arrays->levels;
+    delete env;
+}
@@ -0,0 +1,94 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - batch of games for training bots
+    Version: 1.0
+*/
+
+#ifndef ENV_H
+#define ENV_H
+
+#include <stdint.h>
+
+//**********************
+//* DEFINING CONSTANTS *
+//**********************
+
+#define ENV_CELL_EMPTY 0 // WHAT THE CELLS AROUND THE FROG ARE IN THE OBSERVATIONS
+#define ENV_CELL_OBSTACLE 1
+#define ENV_CELL_CAR 2
+#define ENV_CELL_STOPPING_CAR 3
+#define ENV_CELL_FRIENDLY_CAR 4 // A FRIENDLY CAR WHILE THE FRIENDLY CARS ARE OFF, IT KILLS LIKE ANY OTHER
+#define ENV_CELL_FRIENDLY_CAR_ON 5 // THE FROG CAN RIDE IT
+#define ENV_CELL_STORK 6
+#define ENV_CELL_OUTSIDE 7 // OUTSIDE OF THE BOARD
+
+#define ENV_ACTION_NONE 0 // THE ACTIONS OF THE GAMES
+#define ENV_ACTION_UP 1
+#define ENV_ACTION_DOWN 2
+#define ENV_ACTION_LEFT 3
+#define ENV_ACTION_RIGHT 4
+#define ENV_ACTION_FRIENDLY 5 // TURN THE FRIENDLY CARS ON/OFF
+#define ENV_ACTIONS 6 // NUMBER OF THE ACTIONS, ANY OTHER VALUE IS ENV_ACTION_NONE
+
+#define ENV_RUNNING 0 // VALUES OF THE DONE FLAGS
+#define ENV_TERMINATED 1 // THE FROG DIED OR WON THE LAST LEVEL
+#define ENV_TRUNCATED 2 // THE GAME TOOK max_steps STEPS
+
+#define ENV_CAR_FIELDS 5 // EVERY CAR IS x, y, direction, speed AND ITS CELL CODE
+
+//***********************
+//* DEFINING STRUCTURES *
+//***********************
+
+struct EnvConfig { // How many games, how they are played and what is observed
+    int count; // Number of games stepped together
+    int threads; // 0 for one for every core
+    int rows; // The game itself, like in config.txt
+    int cols;
+    int frog_speed;
+    int car_min_speed;
+    int car_max_speed;
+    int tick_rate;
+    int cars_per_road;
+    int ticks_per_step; // Steps of the engine in one step of a game, the action is given in the first one
+    int max_steps; // A game is cut after this many steps, 0 for no limit
+    int view_rows; // The cells around the frog that are observed, odd numbers so the frog is in the middle
+    int view_cols;
+};
+
+struct EnvArrays { // The results of the last call, every array is one block with the games one after another
+    int count;
+    int view_rows;
+    int view_cols;
+    int car_slots; // Room for this many cars in every game, the empty ones have x = -1
+    uint8_t* observations; // [count][view_rows][view_cols] ENV_CELL_* around the frog
+    int32_t* frogs; // [count][2] x and y of the frog
+    int32_t* storks; // [count][2] x and y of the stork
+    int32_t* cars; // [count][car_slots][ENV_CAR_FIELDS]
+    float* rewards; // [count] points gained in the step, they add up to the score of the game
+    uint8_t* dones; // [count] ENV_RUNNING, ENV_TERMINATED or ENV_TRUNCATED
+    int32_t* points; // [count] score of the game so far
+    int32_t* levels; // [count]
+};
+
+struct BatchEnv; // env.cpp
+
+//*****************
+//* ENV FUNCTIONS *
+//*****************
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void defaultEnvConfig(struct EnvConfig* config);
+struct BatchEnv* createBatchEnv(const struct EnvConfig* config);
+const struct EnvArrays* resetBatchEnv(struct BatchEnv* env, uint64_t seed);
+const struct EnvArrays* stepBatchEnv(struct BatchEnv* env, const int32_t* actions);
+void freeBatchEnv(struct BatchEnv* env);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
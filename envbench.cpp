@@ -0,0 +1,123 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - speed of the batch of games
+    Version: 1.0
+
+    Steps a batch of games (env.h) with random actions, the way a bot would
+    be trained on it, and prints how many steps of games were made per
+    millisecond. Usage:
+        frog-env-bench [--count N] [--threads T] [--steps S] [--seed X] [--ticks K]
+    The checksum adds up the observations, rewards and done flags of every
+    step, the same seed gives the same checksum with any number of threads.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "engine.h"
+#include "env.h"
+
+//**********************
+//* DEFINING CONSTANTS *
+//**********************
+
+#define DEFAULT_STEPS 1000 // CALLS OF stepBatchEnv
+#define DEFAULT_SEED 1
+
+//******************
+//* RANDOM ACTIONS *
+//******************
+
+uint64_t random_state = 0x2545F4914F6CDD1DULL;
+
+int randomAction() {
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 7;
+    random_state ^= random_state << 17;
+    uint64_t r = random_state % 10;
+    return r < 4 ? ENV_ACTION_UP : int(r % ENV_ACTIONS); // mostly up, so the games get somewhere
+}
+
+double seconds() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+//*****************
+//* MAIN FUNCTION *
+//*****************
+
+int main(int argc, char** argv) {
+    EnvConfig config;
+    defaultEnvConfig(&config);
+    int steps = DEFAULT_STEPS;
+    unsigned long long seed = DEFAULT_SEED;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--count") == 0) {
+            config.count = atoi(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--threads") == 0) {
+            config.threads = atoi(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--steps") == 0) {
+            steps = atoi(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--seed") == 0) {
+            seed = strtoull(argv[i + 1], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--ticks") == 0) {
+            config.ticks_per_step = atoi(argv[i + 1]);
+        }
+        else {
+            printf("Unknown option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    BatchEnv* env = createBatchEnv(&config);
+    if (env == NULL) {
+        printf("Error: wrong config!\n");
+        return 1;
+    }
+    int32_t* actions = new int32_t[config.count];
+    double start = seconds();
+    const EnvArrays* arrays = resetBatchEnv(env, seed);
+    double reset_time = seconds() - start;
+
+    unsigned long long checksum = 0;
+    long long finished = 0;
+    long long won = 0;
+    double total_reward = 0.0;
+    double step_time = 0.0;
+    int view = arrays->view_rows * arrays->view_cols;
+    for (int s = 0; s < steps; s++) {
+        for (int i = 0; i < config.count; i++) {
+            actions[i] = randomAction();
+        }
+        start = seconds();
+        arrays = stepBatchEnv(env, actions);
+        step_time += seconds() - start;
+        for (int i = 0; i < config.count; i++) {
+            total_reward += arrays->rewards[i];
+            if (arrays->dones[i] != ENV_RUNNING) {
+                finished++;
+                won += arrays->levels[i] == LAST_LEVEL && arrays->frogs[2 * i] == 0;
+            }
+            checksum = checksum * 31 + arrays->dones[i] * 7 + (unsigned long long)arrays->rewards[i];
+            for (int c = 0; c < view; c++) {
+                checksum += arrays->observations[(size_t)i * view + c] * (c + 1);
+            }
+        }
+    }
+    printf("games: %d, threads: %d, %d engine steps per step\n", config.count, config.threads, config.ticks_per_step);
+    printf("reset: %.1f ms\n", reset_time * 1e3);
+    printf("steps: %lld in %.3f s, %.0f steps of games per ms\n", (long long)steps * config.count, step_time,
+           (double)steps * config.count / (step_time * 1e3));
+    printf("finished games: %lld (won %lld), reward per finished game: %.1f\n", finished, won, finished > 0 ? total_reward / finished : 0.0);
+    printf("checksum: %016llx\n", checksum);
+    delete[] actions;
+    freeBatchEnv(env);
+    return 0;
+}
@@ -0,0 +1,167 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - headless runner
+    Version: 1.0
+
+    Plays many games without a terminal, the frog is moved by a simple greedy
+    policy. Usage:
+        frog-headless [--games N] [--seed S] [--rows R] [--cols C] [--max-time T] [--record FILE] [--leaderboard FILE]
+    With --record the first game is saved, frog-replay can play it again.
+    With --leaderboard the score of every game is added to the given leaderboard.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "alloc_counter.h"
+#include "engine.h"
+#include "leaderboard.h"
+#include "policy.h"
+#include "replay.h"
+
+//**********************
+//* DEFINING CONSTANTS *
+//**********************
+
+#define DEFAULT_GAMES 1000
+#define DEFAULT_ROWS 26 // THE SIZE OF THE BOARD ON A 40x200 TERMINAL
+#define DEFAULT_COLS 50
+#define DEFAULT_MAX_TIME 300 // SIMULATED SECONDS AFTER WHICH A GAME IS STOPPED
+
+//*****************
+//* MAIN FUNCTION *
+//*****************
+
+int main(int argc, char** argv) {
+    int games = DEFAULT_GAMES;
+    unsigned int seed = (unsigned int)time(NULL);
+    double max_time = DEFAULT_MAX_TIME;
+    const char* record_file = NULL;
+    Recording recording;
+    const char* leaderboard_file = NULL;
+    Leaderboard leaderboard;
+
+    GameConfig config;
+    config.frog_speed = 3; // the same values as in the default config.txt
+    config.car_min_speed = 1;
+    config.car_max_speed = 5;
+    config.rows = DEFAULT_ROWS;
+    config.cols = DEFAULT_COLS;
+    config.tick_rate = DEFAULT_TICK_RATE;
+    config.cars_per_road = 1;
+    config.background_levels = false; // the games are played faster than a level is made
+    int board_rows = 0;
+    int board_cols = 0;
+    openConfigFile(&config.frog_speed, &config.car_min_speed, &config.car_max_speed, &config.tick_rate, &board_rows, &board_cols, &config.cars_per_road);
+    if (board_rows > 0 && board_cols > 0) { // 0 means the size of the terminal, which there isn't here
+        config.rows = board_rows;
+        config.cols = board_cols;
+    }
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--games") == 0) {
+            games = atoi(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--seed") == 0) {
+            seed = (unsigned int)strtoul(argv[i + 1], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--rows") == 0) {
+            config.rows = atoi(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--cols") == 0) {
+            config.cols = atoi(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--max-time") == 0) {
+            max_time = atof(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--record") == 0) {
+            record_file = argv[i + 1];
+        }
+        else if (strcmp(argv[i], "--leaderboard") == 0) {
+            leaderboard_file = argv[i + 1];
+        }
+        else {
+            printf("Unknown option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (config.rows < 4 || config.cols < 3) {
+        printf("Error: the board has to be at least 4x3!\n");
+        return 1;
+    }
+
+    int wins = 0;
+    int losses = 0;
+    int timeouts = 0;
+    long long total_points = 0;
+    long long total_steps = 0;
+    double total_time = 0.0;
+    long long play_allocations = 0; // has to stay 0, levels reuse the memory of the board
+    if (leaderboard_file != NULL && !openLeaderboard(&leaderboard, leaderboard_file)) {
+        printf("Error: can't open %s!\n", leaderboard_file);
+        return 1;
+    }
+    clock_t start_time = clock();
+
+    for (int g = 0; g < games; g++) {
+        Game game;
+        config.seed = (unsigned long long)seed + g; // game g is the same in every tool
+        initGame(&game, &config);
+        if (g == 0 && record_file != NULL) {
+            initRecording(&recording, &config);
+            game.recording = &recording;
+        }
+        long long max_ticks = (long long)(max_time * game.config.tick_rate);
+        long long allocations_before = heapAllocations();
+        while (game.status == GAME_RUNNING && game.tick < max_ticks) {
+            step(&game, greedyPolicy(&game));
+        }
+        play_allocations += heapAllocations() - allocations_before;
+        if (game.status == GAME_WON) {
+            wins++;
+        }
+        else if (game.status == GAME_OVER) {
+            losses++;
+        }
+        else {
+            timeouts++;
+        }
+        total_points += CalculatePoints(game.frog, game.timer);
+        total_steps += game.tick;
+        total_time += game.timer->current_time;
+        if (leaderboard_file != NULL) {
+            ScoreEntry entry;
+            makeScoreEntry(&entry, &game);
+            addScore(&leaderboard, &entry);
+        }
+        if (game.recording != NULL) {
+            finishRecording(&recording, &game);
+            saveRecording(&recording, record_file);
+            freeRecording(&recording);
+        }
+        freeGame(&game);
+    }
+
+    double cpu_time = double(clock() - start_time) / CLOCKS_PER_SEC;
+    if (leaderboard_file != NULL) {
+        ScoreEntry best;
+        if (topScores(&leaderboard, 1, &best) == 1) {
+            printf("leaderboard: %lld scores, the best %d points (seed %llu)\n", scoreCount(&leaderboard), best.points, (unsigned long long)best.seed);
+        }
+        closeLeaderboard(&leaderboard);
+    }
+    printf("seed: %u\n", seed);
+    printf("board: %dx%d\n", config.rows, config.cols);
+    printf("games: %d (won %d, lost %d, timed out %d)\n", games, wins, losses, timeouts);
+    if (games > 0) {
+        printf("average points: %.1f\n", double(total_points) / games);
+        printf("average game time: %.2f s\n", total_time / games);
+    }
+    printf("steps: %lld\n", total_steps);
+    printf("heap allocations while playing: %lld\n", play_allocations);
+    if (cpu_time > 0) {
+        printf("games per second: %.0f\n", games / cpu_time);
+    }
+    return 0;
+}
@@ -0,0 +1,216 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - keys read on their own thread
+    Version: 1.0
+
+    While a game is played a thread of its own reads the terminal and puts
+    every key with the time it came into a ring that the game loop empties,
+    so a slow frame doesn't make keys wait, join or get lost, and every key
+    can be given to the step of the engine in which it was pressed. The ring
+    has one writer and one reader, each of them moves only its own counter,
+    so it needs no locks. curses can't be used from two threads, the thread
+    reads the bytes itself and knows only the escape sequences of the arrows
+    (ESC [ A and ESC O A and so on), the other keys are their characters.
+    After every batch of keys a byte in a pipe wakes the game loop up.
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include "clock.h"
+#include "keyboard.h"
+
+//*******************
+//* QUEUE FUNCTIONS *
+//*******************
+
+void initKeyQueue(KeyQueue* queue) {
+    queue->head.store(0, std::memory_order_relaxed);
+    queue->tail.store(0, std::memory_order_relaxed);
+}
+
+// Function to add a key, returns false when the queue is full. Only one thread may call it
+bool pushKey(KeyQueue* queue, const KeyEvent* event) {
+    unsigned tail = queue->tail.load(std::memory_order_relaxed);
+    if (tail - queue->head.load(std::memory_order_acquire) == KEY_QUEUE_SIZE) {
+        return false;
+    }
+    queue->events[tail & (KEY_QUEUE_SIZE - 1)] = *event;
+    queue->tail.store(tail + 1, std::memory_order_release); // the key is written before the reader can see it
+    return true;
+}
+
+// Function to look at the oldest key without taking it. Only the thread that takes the keys may call it
+bool peekKey(KeyQueue* queue, KeyEvent* event) {
+    unsigned head = queue->head.load(std::memory_order_relaxed);
+    if (head == queue->tail.load(std::memory_order_acquire)) {
+        return false;
+    }
+    *event = queue->events[head & (KEY_QUEUE_SIZE - 1)];
+    return true;
+}
+
+// Function to take the oldest key, returns false when there is none
+bool popKey(KeyQueue* queue, KeyEvent* event) {
+    if (!peekKey(queue, event)) {
+        return false;
+    }
+    queue->head.store(queue->head.load(std::memory_order_relaxed) + 1, std::memory_order_release); // its place can be written again
+    return true;
+}
+
+void clearKeys(KeyQueue* queue) {
+    KeyEvent event;
+    while (popKey(queue, &event)) {
+    }
+}
+
+//*******************
+//* THE READ THREAD *
+//*******************
+
+// Function to turn the next byte into a key, returns 0 while an escape sequence isn't finished
+int decodeByte(KeyboardReader* keyboard, unsigned char byte) {
+    if (keyboard->escape == 1) {
+        keyboard->escape = 0;
+        if (byte == '[' || byte == 'O') {
+            keyboard->escape = 2;
+            return 0;
+        }
+        // ESC was a key of its own, the byte after it is decoded as usual
+    }
+    if (keyboard->escape == 2) {
+        keyboard->escape = 0;
+        if (byte == 'A') {
+            return KEYBOARD_UP;
+        }
+        else if (byte == 'B') {
+            return KEYBOARD_DOWN;
+        }
+        else if (byte == 'D') {
+            return KEYBOARD_LEFT;
+        }
+        else if (byte == 'C') {
+            return KEYBOARD_RIGHT;
+        }
+        return 0; // another sequence, e.g. a function key
+    }
+    if (byte == 0x1B) {
+        keyboard->escape = 1;
+        return 0;
+    }
+    return byte;
+}
+
+void readKeys(KeyboardReader* keyboard) {
+    pollfd fds[2];
+    fds[0].fd = keyboard->fd;
+    fds[0].events = POLLIN;
+    fds[1].fd = keyboard->stop_pipe[0];
+    fds[1].events = POLLIN;
+    unsigned char buffer[64];
+    while (true) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        if (fds[1].revents != 0) {
+            return;
+        }
+        ssize_t length = read(keyboard->fd, buffer, sizeof(buffer));
+        if (length < 0 && (errno == EINTR || errno == EAGAIN)) {
+            continue;
+        }
+        if (length <= 0) { // the terminal is gone
+            return;
+        }
+        KeyEvent event;
+        event.time = realTime();
+        for (ssize_t i = 0; i < length; i++) {
+            event.key = decodeByte(keyboard, buffer[i]);
+            if (event.key != 0) {
+                pushKey(&keyboard->queue, &event); // a full queue means 256 keys nobody took, one more doesn't matter
+            }
+        }
+        char byte = 0;
+        if (write(keyboard->wake_pipe[1], &byte, 1) < 0) {
+            // the pipe is full, so the game loop will wake up anyway
+        }
+    }
+}
+
+//********************
+//* READER FUNCTIONS *
+//********************
+
+// Function to make a pipe whose ends never block
+bool openPipe(int fds[2]) {
+    if (pipe(fds) != 0) {
+        return false;
+    }
+    for (int i = 0; i < 2; i++) {
+        int flags = fcntl(fds[i], F_GETFL, 0);
+        fcntl(fds[i], F_SETFL, flags | O_NONBLOCK);
+        fcntl(fds[i], F_SETFD, FD_CLOEXEC);
+    }
+    return true;
+}
+
+// Function to start reading the keys of the terminal fd, nothing else may read it until stopKeyboard
+bool startKeyboard(KeyboardReader* keyboard, int fd) {
+    initKeyQueue(&keyboard->queue);
+    keyboard->fd = fd;
+    keyboard->escape = 0;
+    if (!openPipe(keyboard->wake_pipe)) {
+        return false;
+    }
+    if (!openPipe(keyboard->stop_pipe)) {
+        close(keyboard->wake_pipe[0]);
+        close(keyboard->wake_pipe[1]);
+        return false;
+    }
+    keyboard->thread = std::thread(readKeys, keyboard);
+    return true;
+}
+
+// Function to take the next key without waiting. The pipe is emptied before the queue is looked at
+// the second time, so a key that comes after that always leaves a byte to wake the game loop up
+bool nextKey(KeyboardReader* keyboard, KeyEvent* event) {
+    if (popKey(&keyboard->queue, event)) {
+        return true;
+    }
+    char bytes[64];
+    while (read(keyboard->wake_pipe[0], bytes, sizeof(bytes)) > 0) {
+    }
+    return popKey(&keyboard->queue, event);
+}
+
+// Function to wait for the next key
+void waitKey(KeyboardReader* keyboard, KeyEvent* event) {
+    pollfd input;
+    input.fd = keyboard->wake_pipe[0];
+    input.events = POLLIN;
+    while (!nextKey(keyboard, event)) {
+        poll(&input, 1, -1);
+    }
+}
+
+// Function to get the fd that can be read when there are keys, for waitClock
+int keyboardFd(const KeyboardReader* keyboard) {
+    return keyboard->wake_pipe[0];
+}
+
+void stopKeyboard(KeyboardReader* keyboard) {
+    char byte = 0;
+    if (write(keyboard->stop_pipe[1], &byte, 1) < 0) {
+        // a new pipe is empty, this can't fail
+    }
+    keyboard->thread.join();
+    close(keyboard->wake_pipe[0]);
+    close(keyboard->wake_pipe[1]);
+    close(keyboard->stop_pipe[0]);
+    close(keyboard->stop_pipe[1]);
+}
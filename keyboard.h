@@ -0,0 +1,69 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - keys read on their own thread
+    Version: 1.0
+*/
+
+#ifndef KEYBOARD_H
+#define KEYBOARD_H
+
+#include <atomic>
+#include <thread>
+
+//**********************
+//* DEFINING CONSTANTS *
+//**********************
+
+#define KEY_QUEUE_SIZE 256 // KEYS WAITING FOR THE GAME LOOP, A POWER OF 2
+
+#define KEYBOARD_UP 0x101 // THE ARROWS, THE OTHER KEYS ARE THEIR CHARACTERS
+#define KEYBOARD_DOWN 0x102
+#define KEYBOARD_LEFT 0x103
+#define KEYBOARD_RIGHT 0x104
+
+//***********************
+//* DEFINING STRUCTURES *
+//***********************
+
+struct KeyEvent { // One pressed key
+    double time; // When it was read (realTime), or the time of the clock once the game loop has it
+    int key; // A character or KEYBOARD_*
+};
+
+struct KeyQueue { // Ring of keys from one thread to another one without locks, every counter is written by one side only
+    KeyEvent events[KEY_QUEUE_SIZE];
+    alignas(64) std::atomic<unsigned> head; // Next key to take, moved by the reader of the queue
+    alignas(64) std::atomic<unsigned> tail; // Next free place, moved by the writer of the queue
+};
+
+struct KeyboardReader { // The thread that reads the terminal while a game is played
+    KeyQueue queue;
+    int fd; // The terminal
+    int wake_pipe[2]; // A byte is written after every batch of keys, the game loop waits on wake_pipe[0]
+    int stop_pipe[2]; // Writing a byte here stops the thread
+    int escape; // How much of an escape sequence of an arrow was read (0 - none, 1 - ESC, 2 - ESC [ or ESC O)
+    std::thread thread;
+};
+
+//*******************
+//* QUEUE FUNCTIONS *
+//*******************
+
+void initKeyQueue(KeyQueue* queue);
+bool pushKey(KeyQueue* queue, const KeyEvent* event);
+bool peekKey(KeyQueue* queue, KeyEvent* event);
+bool popKey(KeyQueue* queue, KeyEvent* event);
+void clearKeys(KeyQueue* queue);
+
+//********************
+//* READER FUNCTIONS *
+//********************
+
+int decodeByte(KeyboardReader* keyboard, unsigned char byte);
+bool startKeyboard(KeyboardReader* keyboard, int fd);
+bool nextKey(KeyboardReader* keyboard, KeyEvent* event);
+void waitKey(KeyboardReader* keyboard, KeyEvent* event);
+int keyboardFd(const KeyboardReader* keyboard);
+void stopKeyboard(KeyboardReader* keyboard);
+
+#endif
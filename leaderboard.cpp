@@ -0,0 +1,189 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - leaderboard
+    Version: 1.0
+
+    Every score is kept in ranking.dat, a binary file that is mapped into
+    memory. The first page is a header with the indices of the best
+    LEADERBOARD_TOP entries in order, the entries follow one after another in
+    the order the games were played. Adding a score writes one entry and
+    finds its place among the best ones with a binary search, reading the best
+    scores only touches the header and those entries, so the file can hold
+    millions of games. The numbers are stored as the machine has them.
+*/
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "leaderboard.h"
+
+//******************
+//* FILE FUNCTIONS *
+//******************
+
+LeaderboardHeader* leaderboardHeader(const Leaderboard* leaderboard) {
+    return (LeaderboardHeader*)leaderboard->memory;
+}
+
+ScoreEntry* leaderboardEntries(const Leaderboard* leaderboard) {
+    return (ScoreEntry*)(leaderboard->memory + LEADERBOARD_HEADER_SIZE);
+}
+
+size_t fileSize(uint64_t capacity) {
+    return LEADERBOARD_HEADER_SIZE + capacity * sizeof(ScoreEntry);
+}
+
+// Function to map the file (with the given size) into memory
+bool mapLeaderboard(Leaderboard* leaderboard, size_t size) {
+    void* memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, leaderboard->fd, 0);
+    if (memory == MAP_FAILED) {
+        leaderboard->memory = NULL;
+        return false;
+    }
+    leaderboard->memory = (char*)memory;
+    leaderboard->size = size;
+    return true;
+}
+
+// Function to open the leaderboard, the file is locked until it is closed so two games don't write at once
+bool openLeaderboard(Leaderboard* leaderboard, const char* filename) {
+    leaderboard->memory = NULL;
+    leaderboard->size = 0;
+    leaderboard->fd = open(filename, O_RDWR | O_CREAT, 0644);
+    if (leaderboard->fd < 0) {
+        return false;
+    }
+    flock(leaderboard->fd, LOCK_EX);
+    struct stat info;
+    if (fstat(leaderboard->fd, &info) != 0) {
+        closeLeaderboard(leaderboard);
+        return false;
+    }
+    if (info.st_size == 0) { // a new file
+        size_t size = fileSize(LEADERBOARD_MIN_CAPACITY);
+        if (ftruncate(leaderboard->fd, size) != 0 || !mapLeaderboard(leaderboard, size)) {
+            closeLeaderboard(leaderboard);
+            return false;
+        }
+        memcpy(leaderboardHeader(leaderboard)->magic, LEADERBOARD_MAGIC, 8);
+        leaderboardHeader(leaderboard)->count = 0;
+        leaderboardHeader(leaderboard)->capacity = LEADERBOARD_MIN_CAPACITY;
+        leaderboardHeader(leaderboard)->top_count = 0;
+        return true;
+    }
+    if ((size_t)info.st_size < LEADERBOARD_HEADER_SIZE || !mapLeaderboard(leaderboard, info.st_size)) {
+        closeLeaderboard(leaderboard);
+        return false;
+    }
+    const LeaderboardHeader* head = leaderboardHeader(leaderboard);
+    if (memcmp(head->magic, LEADERBOARD_MAGIC, 8) != 0 || fileSize(head->capacity) > leaderboard->size
+        || head->count > head->capacity || head->top_count > LEADERBOARD_TOP) {
+        closeLeaderboard(leaderboard); // not a leaderboard or a broken one, it is left as it is
+        return false;
+    }
+    return true;
+}
+
+// Function to make the file twice as big when it is full
+bool growLeaderboard(Leaderboard* leaderboard) {
+    uint64_t capacity = leaderboardHeader(leaderboard)->capacity * 2;
+    munmap(leaderboard->memory, leaderboard->size);
+    leaderboard->memory = NULL;
+    if (ftruncate(leaderboard->fd, fileSize(capacity)) != 0 || !mapLeaderboard(leaderboard, fileSize(capacity))) {
+        return false;
+    }
+    leaderboardHeader(leaderboard)->capacity = capacity;
+    return true;
+}
+
+void closeLeaderboard(Leaderboard* leaderboard) {
+    if (leaderboard->memory != NULL) {
+        munmap(leaderboard->memory, leaderboard->size);
+        leaderboard->memory = NULL;
+    }
+    if (leaderboard->fd >= 0) {
+        close(leaderboard->fd); // this also unlocks the file
+        leaderboard->fd = -1;
+    }
+}
+
+//*******************
+//* SCORE FUNCTIONS *
+//*******************
+
+// Function to fill in the entry for a finished game
+void makeScoreEntry(ScoreEntry* entry, const Game* game) {
+    memset(entry, 0, sizeof(ScoreEntry));
+    entry->points = CalculatePoints(game->frog, game->timer);
+    entry->level = game->frog->level;
+    entry->lanes_passed = game->frog->lanes_passed;
+    entry->status = game->status;
+    entry->time = game->timer->current_time;
+    entry->frog_speed = game->config.frog_speed;
+    entry->car_min_speed = game->config.car_min_speed;
+    entry->car_max_speed = game->config.car_max_speed;
+    entry->rows = game->config.rows;
+    entry->cols = game->config.cols;
+    entry->tick_rate = game->config.tick_rate;
+    entry->cars_per_road = game->config.cars_per_road;
+    entry->seed = game->config.seed;
+    entry->date = (int64_t)time(NULL);
+}
+
+// Function to add a score: the entry goes to the end of the file and its index is put among the best ones
+bool addScore(Leaderboard* leaderboard, const ScoreEntry* entry) {
+    if (leaderboardHeader(leaderboard)->count == leaderboardHeader(leaderboard)->capacity && !growLeaderboard(leaderboard)) {
+        return false;
+    }
+    LeaderboardHeader* head = leaderboardHeader(leaderboard);
+    const ScoreEntry* all = leaderboardEntries(leaderboard);
+    uint32_t index = (uint32_t)head->count;
+    leaderboardEntries(leaderboard)[index] = *entry;
+    head->count++;
+
+    // the first place with fewer points, so among equal scores the older one stays higher
+    int low = 0;
+    int high = head->top_count;
+    while (low < high) {
+        int middle = (low + high) / 2;
+        if (all[head->top[middle]].points >= entry->points) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+    if (low == LEADERBOARD_TOP) {
+        return true; // not good enough to be among the best
+    }
+    int moved = (int)head->top_count - low;
+    if (head->top_count == LEADERBOARD_TOP) {
+        moved--; // the last one falls out
+    }
+    else {
+        head->top_count++;
+    }
+    memmove(&head->top[low + 1], &head->top[low], moved * sizeof(uint32_t));
+    head->top[low] = index;
+    return true;
+}
+
+// Function to copy the best n scores, the best first, returns how many there were
+int topScores(const Leaderboard* leaderboard, int n, ScoreEntry* out) {
+    const LeaderboardHeader* head = leaderboardHeader(leaderboard);
+    if (n > (int)head->top_count) {
+        n = (int)head->top_count;
+    }
+    for (int i = 0; i < n; i++) {
+        out[i] = leaderboardEntries(leaderboard)[head->top[i]];
+    }
+    return n;
+}
+
+long long scoreCount(const Leaderboard* leaderboard) {
+    return (long long)leaderboardHeader(leaderboard)->count;
+}
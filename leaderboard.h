@@ -0,0 +1,70 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - leaderboard
+    Version: 1.0
+*/
+
+#ifndef LEADERBOARD_H
+#define LEADERBOARD_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "engine.h"
+
+//**********************
+//* DEFINING CONSTANTS *
+//**********************
+
+#define LEADERBOARD_MAGIC "FROGLB01" // FIRST 8 BYTES OF THE FILE
+#define LEADERBOARD_TOP 500 // NUMBER OF THE BEST SCORES KEPT IN ORDER
+#define LEADERBOARD_HEADER_SIZE 4096 // THE ENTRIES START ON THE SECOND PAGE
+#define LEADERBOARD_MIN_CAPACITY 1024 // ENTRIES THAT FIT INTO A NEW FILE
+
+//***********************
+//* DEFINING STRUCTURES *
+//***********************
+
+struct ScoreEntry { // One finished game, 64 bytes in the file
+    int32_t points;
+    int32_t level;
+    int32_t lanes_passed;
+    int16_t status;
+    int16_t cars_per_road; // Most cars on one road
+    double time; // Seconds that the game took
+    int32_t frog_speed; // The rest of the config of the game
+    int32_t car_min_speed;
+    int32_t car_max_speed;
+    int32_t rows;
+    int32_t cols;
+    int32_t tick_rate;
+    uint64_t seed; // Together with last_game.rec it lets the game be checked
+    int64_t date; // Seconds since 1970
+};
+
+struct LeaderboardHeader { // The first page of the file
+    char magic[8];
+    uint64_t count; // Number of entries in the file
+    uint64_t capacity; // Number of entries that fit into the file
+    uint32_t top_count;
+    uint32_t reserved;
+    uint32_t top[LEADERBOARD_TOP]; // Indices of the best entries, the best first
+};
+
+struct Leaderboard { // The file mapped into memory
+    int fd;
+    char* memory;
+    size_t size;
+};
+
+//*************************
+//* LEADERBOARD FUNCTIONS *
+//*************************
+
+void makeScoreEntry(ScoreEntry* entry, const Game* game);
+bool openLeaderboard(Leaderboard* leaderboard, const char* filename);
+bool addScore(Leaderboard* leaderboard, const ScoreEntry* entry);
+int topScores(const Leaderboard* leaderboard, int n, ScoreEntry* out);
+long long scoreCount(const Leaderboard* leaderboard);
+void closeLeaderboard(Leaderboard* leaderboard);
+
+#endif
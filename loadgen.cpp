@@ -0,0 +1,317 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - load generator for the game server
+    Version: 1.0
+
+    Connects many clients to frog-server from one thread and presses random
+    keys in all of them, the frames that come back are counted and thrown
+    away. Every second it prints how many clients are connected and how many
+    frames each of them gets, a server that keeps up sends FRAME_RATE (10)
+    frames per second to every client. Usage:
+        frog-load [--host H] [--port P] [--unix PATH] [--clients N] [--seconds S] [--keys K]
+    --keys is the number of keys every client presses per second.
+*/
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+//**********************
+//* DEFINING CONSTANTS *
+//**********************
+
+#define DEFAULT_HOST "127.0.0.1"
+#define DEFAULT_PORT 4000
+#define DEFAULT_CLIENTS 1000
+#define DEFAULT_SECONDS 10
+#define DEFAULT_KEYS 2
+#define LOAD_TICK_RATE 100 // THE KEYS AND THE NEW CONNECTIONS ARE HANDLED THIS MANY TIMES PER SECOND
+#define CONNECT_BATCH 50 // NEW CONNECTIONS PER TICK, SO THE QUEUE OF THE SERVER DOESN'T OVERFLOW
+#define MAX_EVENTS 256
+
+const char KEYS[] = "wwwwasd r"; // mostly up, so the games get somewhere. r starts a new game after the end of one
+
+//***********************
+//* DEFINING STRUCTURES *
+//***********************
+
+struct Client {
+    int fd; // -1 before it is connected and after it is closed
+    bool connected;
+    int match; // How much of "\x1b[H" (the start of a frame) was seen at the end of the last read
+    long long next_key; // Tick in which the client presses the next key
+};
+
+struct LoadStats {
+    int connected;
+    int failed;
+    int closed;
+    long long frames;
+    long long bytes;
+};
+
+//**********************
+//* RANDOM KEY PRESSES *
+//**********************
+
+uint64_t random_state = 0x2545F4914F6CDD1DULL;
+
+int randomInt(int n) {
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 7;
+    random_state ^= random_state << 17;
+    return int(random_state % (uint64_t)n);
+}
+
+// Function to pick the tick of the next key, on average keys times per second
+long long nextKeyTick(long long tick, int keys) {
+    int interval = keys > 0 ? LOAD_TICK_RATE / keys : LOAD_TICK_RATE * 3600;
+    return tick + 1 + randomInt(interval * 2 > 0 ? interval * 2 : 1);
+}
+
+//****************************
+//* CLIENT RELATED FUNCTIONS *
+//****************************
+
+// Function to start connecting the client, returns false if it failed at once
+bool connectClient(Client* client, int epoll_fd, const sockaddr* address, socklen_t length, long long tick, int keys) {
+    client->fd = socket(address->sa_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (client->fd < 0) {
+        return false;
+    }
+    if (connect(client->fd, address, length) != 0 && errno != EINPROGRESS) {
+        close(client->fd);
+        client->fd = -1;
+        return false;
+    }
+    client->connected = false;
+    client->match = 0;
+    client->next_key = nextKeyTick(tick, keys);
+    epoll_event event;
+    event.events = EPOLLIN | EPOLLOUT; // EPOLLOUT tells that the connection is made
+    event.data.ptr = client;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client->fd, &event);
+    return true;
+}
+
+void closeClient(Client* client, int epoll_fd) {
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, client->fd, NULL);
+    close(client->fd);
+    client->fd = -1;
+    client->connected = false;
+}
+
+// Function to read and count everything the server sent, returns false if the connection is closed
+bool readFrames(Client* client, LoadStats* stats) {
+    static char data[65536];
+    const char start[] = "\x1b[H";
+    while (true) {
+        ssize_t length = recv(client->fd, data, sizeof(data), 0);
+        if (length > 0) {
+            stats->bytes += length;
+            for (ssize_t i = 0; i < length; i++) { // the start of a frame may be split between two reads
+                if (data[i] == start[client->match]) {
+                    client->match++;
+                    if (client->match == 3) {
+                        stats->frames++;
+                        client->match = 0;
+                    }
+                }
+                else {
+                    client->match = data[i] == start[0] ? 1 : 0;
+                }
+            }
+        }
+        else if (length < 0 && errno == EINTR) {
+            continue;
+        }
+        else if (length < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return true;
+        }
+        else {
+            return false;
+        }
+    }
+}
+
+//*****************
+//* MAIN FUNCTION *
+//*****************
+
+int main(int argc, char** argv) {
+    const char* host = DEFAULT_HOST;
+    int port = DEFAULT_PORT;
+    const char* unix_path = NULL;
+    int clients = DEFAULT_CLIENTS;
+    int seconds = DEFAULT_SECONDS;
+    int keys = DEFAULT_KEYS;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--host") == 0) {
+            host = argv[i + 1];
+        }
+        else if (strcmp(argv[i], "--port") == 0) {
+            port = atoi(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--unix") == 0) {
+            unix_path = argv[i + 1];
+        }
+        else if (strcmp(argv[i], "--clients") == 0) {
+            clients = atoi(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--seconds") == 0) {
+            seconds = atoi(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--keys") == 0) {
+            keys = atoi(argv[i + 1]);
+        }
+        else {
+            printf("Unknown option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (clients < 1 || seconds < 1) {
+        printf("Error: --clients and --seconds have to be at least 1!\n");
+        return 1;
+    }
+
+    sockaddr_storage address;
+    socklen_t address_length;
+    memset(&address, 0, sizeof(address));
+    if (unix_path != NULL) {
+        sockaddr_un* unix_address = (sockaddr_un*)&address;
+        if (strlen(unix_path) >= sizeof(unix_address->sun_path)) {
+            printf("Error: the socket path is too long!\n");
+            return 1;
+        }
+        unix_address->sun_family = AF_UNIX;
+        strcpy(unix_address->sun_path, unix_path);
+        address_length = sizeof(sockaddr_un);
+    }
+    else {
+        sockaddr_in* tcp_address = (sockaddr_in*)&address;
+        tcp_address->sin_family = AF_INET;
+        tcp_address->sin_port = htons(port);
+        if (inet_pton(AF_INET, host, &tcp_address->sin_addr) != 1) {
+            printf("Error: %s isn't an IPv4 address!\n", host);
+            return 1;
+        }
+        address_length = sizeof(sockaddr_in);
+    }
+
+    rlimit limit; // every client is an open file
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    Client* all = new Client[clients];
+    for (int i = 0; i < clients; i++) {
+        all[i].fd = -1;
+        all[i].connected = false;
+    }
+    LoadStats stats;
+    memset(&stats, 0, sizeof(stats));
+    long long last_frames = 0;
+    long long last_bytes = 0;
+
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    int timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    itimerspec interval;
+    interval.it_interval.tv_sec = 0;
+    interval.it_interval.tv_nsec = 1000000000L / LOAD_TICK_RATE;
+    interval.it_value = interval.it_interval;
+    timerfd_settime(timer_fd, 0, &interval, NULL);
+    epoll_event timer_event;
+    timer_event.events = EPOLLIN;
+    timer_event.data.ptr = NULL;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, timer_fd, &timer_event);
+
+    long long tick = 0;
+    int started = 0; // clients that tried to connect
+    epoll_event events[MAX_EVENTS];
+    while (tick < (long long)seconds * LOAD_TICK_RATE) {
+        int count = epoll_wait(epoll_fd, events, MAX_EVENTS, -1);
+        for (int e = 0; e < count; e++) {
+            if (events[e].data.ptr == NULL) {
+                uint64_t expirations = 0;
+                if (read(timer_fd, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+                    continue;
+                }
+                tick += expirations;
+                for (int i = 0; i < CONNECT_BATCH && started < clients; i++, started++) {
+                    if (!connectClient(&all[started], epoll_fd, (sockaddr*)&address, address_length, tick, keys)) {
+                        stats.failed++;
+                    }
+                }
+                for (int i = 0; i < started; i++) {
+                    Client* client = &all[i];
+                    if (client->connected && client->next_key <= tick) {
+                        char key = KEYS[randomInt(sizeof(KEYS) - 1)];
+                        send(client->fd, &key, 1, MSG_NOSIGNAL);
+                        client->next_key = nextKeyTick(tick, keys);
+                    }
+                }
+                if (tick / LOAD_TICK_RATE != (tick - (long long)expirations) / LOAD_TICK_RATE) { // once a second
+                    printf("%3llds: %d connected, %d failed, %d closed, %.1f frames/s per client, %.2f MB/s\n", tick / LOAD_TICK_RATE,
+                           stats.connected, stats.failed, stats.closed,
+                           stats.connected > 0 ? double(stats.frames - last_frames) / stats.connected : 0.0, (stats.bytes - last_bytes) / 1e6);
+                    fflush(stdout);
+                    last_frames = stats.frames;
+                    last_bytes = stats.bytes;
+                }
+                continue;
+            }
+            Client* client = (Client*)events[e].data.ptr;
+            if (client->fd < 0) {
+                continue;
+            }
+            if (!client->connected) {
+                int error = 0;
+                socklen_t length = sizeof(error);
+                getsockopt(client->fd, SOL_SOCKET, SO_ERROR, &error, &length);
+                if (error != 0 || (events[e].events & (EPOLLERR | EPOLLHUP))) {
+                    closeClient(client, epoll_fd);
+                    stats.failed++;
+                    continue;
+                }
+                client->connected = true;
+                stats.connected++;
+                epoll_event event;
+                event.events = EPOLLIN; // the keys are single bytes, the socket always takes them
+                event.data.ptr = client;
+                epoll_ctl(epoll_fd, EPOLL_CTL_MOD, client->fd, &event);
+            }
+            if ((events[e].events & EPOLLIN) && !readFrames(client, &stats)) {
+                closeClient(client, epoll_fd);
+                stats.connected--;
+                stats.closed++;
+            }
+        }
+    }
+
+    for (int i = 0; i < clients; i++) {
+        if (all[i].fd >= 0) {
+            char quit = 'q';
+            send(all[i].fd, &quit, 1, MSG_NOSIGNAL);
+            closeClient(&all[i], epoll_fd);
+        }
+    }
+    printf("clients: %d (connected at the end %d, failed %d, closed by the server %d)\n", clients, stats.connected, stats.failed, stats.closed);
+    printf("frames: %lld (%.1f per client per second)\n", stats.frames, double(stats.frames) / clients / seconds);
+    printf("received: %.1f MB\n", stats.bytes / 1e6);
+    delete[] all;
+    close(timer_fd);
+    close(epoll_fd);
+    return 0;
+}
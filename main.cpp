@@ -5,661 +5,87 @@
 */
 
 #include <curses.h>
+#include <errno.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
+#include <unistd.h>
+#include "clock.h"
+#include "engine.h"
+#include "keyboard.h"
+#include "leaderboard.h"
+#include "profiler.h"
+#include "render.h"
+#include "replay.h"
+#include "rewind.h"
 
 //**********************
 //* DEFINING CONSTANTS *
 //**********************
 
-#define NUMROWS LINES * 2 / 3 // DEFINING BOARD SIZE PARAMETERS
+#define NUMROWS LINES * 2 / 3 // BOARD SIZE WHEN config.txt DOESN'T GIVE ONE
 #define NUMCOLS (COLS / 4)
 
-#define MINIMUM NUMROWS/2 // DEFINING MINIMUM AND MAXIMUM NUMBER OF ROADS
-#define MAXIMUM NUMROWS-2
-
-#define END_COLOR 1 // DEFINING COLORS
-#define FREE_COLOR 2 // DEFINE THE COLOR OF THE FREE AREA
-#define OBSTACLE_COLOR 3 
-#define START_COLOR 4 // DEFINE THE COLOR OF THE STARTING AREA
-#define FROG_COLOR 5
-#define FRIENDLY_COLOR 6 // COLOR OF A FRIENDLY CAR THAT IS TURNED ON
-#define STORK_COLOR 7
-
-//***********************
-//* DEFINING STRUCTURES *
-//***********************
-
-struct Car {
-    int x; // Car's position
-    int y;
-    int direction; // 0 for left, 1 for right
-    char symbol;
-    bool stop_now; // Boolean to check wherer the car should stop now
-    int speed;
-    clock_t last_move_time; // Time of the last move
-};
-
-struct Road {
-    int x; // Road's row
-    Car car; // Car on the road
-};
-
-struct FreeRow { // Define a row on which there is no road
-    bool is_free;
-    bool* obstacles;
-};
-
-struct Board {
-    int rows; // Board's size
-    int cols;
-    char** grid; // Grid of the board
-    Road* roads; // Array of roads
-    FreeRow* free_rows;
-    int num_roads; // Number of roads
-    int car_min_speed; // Minimum and maximum speed of the cars
-    int car_max_speed;
-    int spaces_count; // The number of spaces clicked in order to decide if the friendly car should be on/off
-    bool friendly_on; // Boolean to check wheter the friednly cars shoudl be on
-};
-
-struct Object { // define the object that is frog
-    int x; // Object's position
-    int y;
-    char symbol;
-    int speed; // Object's speed
-    clock_t last_move_time; // Time of the last move
-    int last_key; // Last key pressed
-    bool on_friendly_car; // Boolean to check wheter the frog is on the friendly car
-    int friendly_car_index; // Index of the friendly car
-    int level; // the level in which the frog is currently in
-    int lanes_passed;
-};
-
-struct Stork { //Creating a stork that will chase the frog
-    int x;
-    int y;
-    char symbol;
-    int speed;
-    clock_t last_move_time;
-};
-
-struct Timer {
-    clock_t start_time;
-    double current_time;
-};
-
-//*************************
-//* COLORS INITIALIZATION *
-//*************************
-
-void createColorPairs() {
-    start_color();
-    init_pair(END_COLOR, COLOR_GREEN, COLOR_GREEN);
-    init_pair(START_COLOR, COLOR_RED, COLOR_RED);
-    init_pair(FREE_COLOR, COLOR_YELLOW, COLOR_WHITE);
-    init_pair(OBSTACLE_COLOR, COLOR_BLACK, COLOR_WHITE);
-    init_pair(FROG_COLOR, COLOR_BLUE, COLOR_BLUE);
-    init_pair(FRIENDLY_COLOR, COLOR_WHITE, COLOR_GREEN);
-    init_pair(STORK_COLOR, COLOR_WHITE, COLOR_RED);
-}
-
-//****************************
-//* FREE THE MEMORY FUNCTION *
-//****************************
-
-void freeMemory(Board* board, Object* frog, Timer* timer, Stork* stork) {
-    for (int i = 0; i < board->rows; i++) {
-        delete[] board->grid[i];
-        if (i != 0 && i != board->rows - 1) {
-            delete[] board->free_rows[i].obstacles;
-        }
-    }
-    delete[] board->grid;
-    delete[] board->roads;
-    delete[] board->free_rows;
-    delete board;
-    delete frog;
-    delete timer;
-    delete stork;
-}
-
-//***************************
-//* TIMER RELATED FUNCTIONS *
-//***************************
-
-void initTimer(Timer* timer) {
-    timer->start_time = clock();
-    timer->current_time = 0.00;
-}
-
-void updateTimer(Timer* timer) {
-    timer->current_time = double(clock() - timer->start_time) / CLOCKS_PER_SEC; // getting the current time in seconds
-}
-
-void showTimer(Timer* timer) {
-    mvprintw(NUMROWS / 2, NUMCOLS + 1, "Time: %.2f s", timer->current_time);
-}
-
-//***************************
-//* BOARD RELATED FUNCTIONS *
-//***************************
-
-// Function to initialize the grid of the board
-void initGrid(Board* board) {
-    board->grid = new char* [board->rows];
-    for (int i = 0; i < board->rows; i++) {
-        board->grid[i] = new char[board->cols];
-        for (int j = 0; j < board->cols - 1; j++) {
-            board->grid[i][j] = ' ';
-        }
-        board->grid[i][board->cols - 1] = '\0';
-    }
-}
-
-// Find a free row for the road
-void findRow(Board* board, int i) {
-    board->roads[i].x = (rand() % (NUMROWS - 2)) + 1; // Random road position
-    bool is_occupied = false;
-    do {
-        is_occupied = false;
-        for (int j = 0; j < i; j++) {
-            if (board->roads[i].x == board->roads[j].x) {
-                is_occupied = true;
-                break;
-            }
-        }
-        if (is_occupied) {
-            board->roads[i].x++;
-            if (board->roads[i].x >= NUMROWS - 1) {
-                board->roads[i].x = 1;
-            }
-        }
-    } while (is_occupied);
-}
-
-// Function to initialize the car
-void initCar(Board* board, int i) {
-    board->roads[i].car.x = board->roads[i].x;
-    int left_right = rand() % 2; // The car is placed randomly on left or right edge of the row
-    if (left_right == 0) { // Car spawns on the left edge and is moving to right edge
-        board->roads[i].car.direction = 1;
-        board->roads[i].car.y = 0;
-    }
-    else { // Car spawns on the right edge and is moving to left edge
-        board->roads[i].car.direction = -1;
-        board->roads[i].car.y = board->cols - 2;
-    }
-    int which_symbol = rand() % 3;
-    if (which_symbol == 0) {
-        board->roads[i].car.symbol = 'C';
-    }
-    else if (which_symbol == 1) {
-        board->roads[i].car.symbol = 'S';
-    }
-    else {
-        board->roads[i].car.symbol = 'F';
-    }
-    board->roads[i].car.stop_now = false;
-    board->roads[i].car.speed = board->car_min_speed + rand() % (board->car_max_speed - board->car_min_speed + 1); // Random speed of the car
-    board->roads[i].car.last_move_time = clock();
-}
-
-// Function to initialize the roads of the board
-void initRoads(Board* board) {
-    board->num_roads = (MINIMUM + rand() % ((MAXIMUM - MINIMUM) + 1)); // Random number of roads
-    board->roads = new Road[board->num_roads];
-    for (int i = 0; i < board->num_roads; i++) {
-        findRow(board, i); // Calling a function to find a free row for the road
-        board->free_rows[board->roads[i].x].is_free = false; // Marking the row as occupied
-        initCar(board, i); // Calling a function to initialize the car
-    }
-}
-
-// Function to initialize the board
-void initBoard(Board* board, int MINSPEED, int MAXSPEED) {
-    board->rows = NUMROWS;
-    board->cols = NUMCOLS;
-    board->free_rows = new FreeRow[board->rows];
-    for (int i = 0; i < board->rows; i++) {
-        if (i == 0 || i == board->rows - 1) {
-            board->free_rows[i].is_free = false;
-        }
-        else {
-            board->free_rows[i].is_free = true;
-            board->free_rows[i].obstacles = new bool[board->cols - 1];
-            int distance_between_obstacles = rand() % 5 + 1;
-            if (distance_between_obstacles != 1) {
-                for (int j = 0; j < board->cols - 1; j++) {
-                    if (j % distance_between_obstacles == 0) {
-                        board->free_rows[i].obstacles[j] = true;
-                    }
-                    else {
-                        board->free_rows[i].obstacles[j] = false;
-                    }
-                }
-            }
-            else {
-                for (int j = 0; j < board->cols - 1; j++) {
-                    board->free_rows[i].obstacles[j] = false;
-                }
-            }
-        }
-    }
-    board->car_min_speed = MINSPEED;
-    board->car_max_speed = MAXSPEED;
-    board->spaces_count = 0;
-    board->friendly_on = false;
-    initGrid(board);
-    initRoads(board);
-}
-
-// Function to print the grid of the board
-void printGrid(Board* board) {
-    for (int i = 0; i < board->rows; i++) {
-        //deciding the color of the row
-        if (i == 0) {
-            attron(COLOR_PAIR(END_COLOR));
-            mvprintw(i, 0, board->grid[i]);
-            attroff(COLOR_PAIR(END_COLOR));
-        }
-        else if (i == board->rows - 1) {
-            attron(COLOR_PAIR(START_COLOR));
-            mvprintw(i, 0, board->grid[i]);
-            attroff(COLOR_PAIR(START_COLOR));
-        }
-        else {
-            if (board->free_rows[i].is_free) {
-                for (int j = 0; j < board->cols - 1; j++) {
-                    if (board->free_rows[i].obstacles[j]) {
-                        attron(COLOR_PAIR(OBSTACLE_COLOR));
-                        mvaddch(i, j, 'X');
-                        attroff(COLOR_PAIR(OBSTACLE_COLOR));
-                    }
-                    else {
-                        attron(COLOR_PAIR(FREE_COLOR));
-                        mvaddch(i, j, board->grid[i][j]);
-                        attroff(COLOR_PAIR(FREE_COLOR));
-                    }
-                }
-            }
-        }
-    }
-}
-
-// Function to print the roads of the board
-void printRoads(Board* board) {
-    for (int i = 0; i < board->num_roads; i++) {
-        for (int j = 0; j < NUMCOLS - 1; j++) {
-            mvaddch(board->roads[i].x, j, '-');
-        }
-    }
-}
-
-// Function to print the board
-void printBoard(Board* board) {
-    printGrid(board);
-    printRoads(board);
-}
-
-//*************************
-//* CAR RELATED FUNCTIONS *
-//*************************
-
-// Changing the friendly cars on demand
-void FriendlyOnOff(Board* board) {
-    board->spaces_count++;
-    for (int i = 0; i < board->num_roads; i++) {
-        if (board->roads[i].car.symbol == 'F') {
-            if (board->spaces_count % 2 == 0) {
-                board->friendly_on = false;
-            }
-            else {
-                board->friendly_on = true;
-            }
-        }
-    }
-}
-
-bool disappearCar(Board* board, int i) {
-    int disappear = rand() % 2;
-    if (disappear && board->roads[i].car.symbol != 'F') {
-        initCar(board, i);
-        return true;
-    }
-    return false;
-}
-// Update the position of the cars
-void updateCars(Board* board, Object* frog) {
-    for (int i = 0; i < board->num_roads; i++) {
-        Car* car = &board->roads[i].car;
-        clock_t current_time = clock(); // Calulate the last time since last move
-        double passed_time = double(current_time - car->last_move_time) / CLOCKS_PER_SEC;
-        if (car->symbol == 'S') { // Checking if the car should stop
-            if (car->x == frog->x || car->x == frog->x - 1) {
-
-                if (car->direction == 1 && frog->y > car->y && frog->y - car->y <= 2) {
-                    car->stop_now = true;
-                }
-                else if (car->direction == -1 && frog->y < car->y && car->y - frog->y <= 2) {
-                    car->stop_now = true;
-                }
-                else {
-                    car->stop_now = false;
-                }
-            }
-            else {
-                car->stop_now = false;
-            }
-        }
-        if (!car->stop_now && passed_time >= 1.0 / car->speed) { // Car speed delay
-            car->y += car->direction;
-            if (frog->friendly_car_index == i && frog->on_friendly_car) {
-                frog->y += car->direction;
-            }
-            if (car->y >= NUMCOLS - 1) {
-                if (!disappearCar(board, i)) {
-                    if (frog->friendly_car_index == i && frog->on_friendly_car) {
-                        frog->y = NUMCOLS - 2;
-                        frog->on_friendly_car = false;
-                    }
-                    car->y = 0;
-                }
-            }
-            if (car->y < 0) {
-                if (!disappearCar(board, i)) {
-                    if (frog->friendly_car_index == i && frog->on_friendly_car) {
-                        frog->y = 0;
-                        frog->on_friendly_car = false;
-                    }
-                    car->y = NUMCOLS - 2;
-                }
-            }
-            car->last_move_time = current_time;
-        }
-    }
-}
-
-// Function to randomly change the speed of the cars during the game
-void updateCarsSpeed(Board* board) {
-    for (int i = 0; i < board->num_roads; i++) {
-        int change_speed = rand() % 2; // 50% chance to change the speed
-        if (change_speed) {
-            board->roads[i].car.speed = board->car_min_speed + rand() % (board->car_max_speed - board->car_min_speed + 1);
-        }
-    }
-}
-
-// Function to draw the cars
-void drawCars(Board* board) {
-    for (int i = 0; i < board->num_roads; i++) {
-        if (board->roads[i].car.symbol == 'F' && board->friendly_on) {
-            attron(COLOR_PAIR(FRIENDLY_COLOR));
-            mvaddch(board->roads[i].car.x, board->roads[i].car.y, board->roads[i].car.symbol);
-            attroff(COLOR_PAIR(FRIENDLY_COLOR));
-        }
-        else {
-            mvaddch(board->roads[i].car.x, board->roads[i].car.y, board->roads[i].car.symbol);
-        }
-    }
-}
-
-//**************************
-//* FROG RELATED FUNCTIONS *
-//**************************
-
-// Function to initialize the frog
-void initObject(Object* frog, int x, int y, char symbol, int speed) {
-    frog->x = x;
-    frog->y = y;
-    frog->symbol = symbol;
-    frog->speed = speed;
-    frog->level = 1;
-    frog->last_move_time = clock(); // Initialize the time of the last move
-    frog->last_key = 0; // Initialize the last clicked key
-    frog->lanes_passed = 0;
-}
-
-
-// Function to draw the frog
-void drawObject(const Object* frog) {
-    attron(COLOR_PAIR(FROG_COLOR));
-    mvaddch(frog->x, frog->y, frog->symbol);
-    attroff(COLOR_PAIR(FROG_COLOR));
-}
-
-// Function to move the frog up
-void moveUp(Object* frog, const Board* board, clock_t current_time) {
-    if (frog->x > 0) {
-        bool noObstacle = true;
-        if (board->free_rows[frog->x - 1].is_free == true) { // checking if there is no obstacle in the row above
-            if (board->free_rows[frog->x - 1].obstacles[frog->y] == true) {
-                noObstacle = false;
-            }
-        }
-        if (noObstacle) {
-            frog->x--;
-            frog->lanes_passed++;
-            frog->last_key = 0;
-            frog->last_move_time = current_time;
-        }
-    }
-}
-
-// Function to move the frog down
-void moveDown(Object* frog, const Board* board, clock_t current_time) {
-    if (frog->x < board->rows - 1) {
-        bool noObstacle = true;
-        if (board->free_rows[frog->x + 1].is_free == true) { // checking if there is no obstacle in the row below
-            if (board->free_rows[frog->x + 1].obstacles[frog->y] == true) {
-                noObstacle = false;
-            }
-        }
-        if (noObstacle) {
-            frog->x++;
-            frog->lanes_passed--;
-            frog->last_key = 0;
-            frog->last_move_time = current_time;
-        }
-    }
-}
-
-// Function to move the frog left
-void moveLeft(Object* frog, const Board* board, clock_t current_time) {
-    if (frog->y > 0) {
-        bool noObstacle = true;
-        if (board->free_rows[frog->x].is_free == true) { // checking if there is no obstacle to the left
-            if (board->free_rows[frog->x].obstacles[frog->y - 1] == true) {
-                noObstacle = false;
-            }
-        }
-        if (noObstacle) {
-            frog->y--;
-            frog->last_key = 0;
-            frog->last_move_time = current_time;
-        }
-    }
-}
+#define MAX_CATCH_UP 0.25 // THE MOST OF THE REAL TIME (IN SECONDS) THAT IS SIMULATED AT ONCE
+#define TIME_TOLERANCE 1e-9 // ROUNDING ERRORS OF THE ADDED UP TIME, A CLOCK THAT NEVER WAITS COULD GET STUCK ON THEM
+#define FAST_FRAME_TIME (1.0 / 60) // A GAME FASTER THAN THE REAL TIME IS DRAWN AT MOST THIS OFTEN (IN REAL SECONDS)
+#define HUD_REFRESH 0.05 // THE CLOCK ON THE SCREEN IS REDRAWN AT LEAST THIS OFTEN (IN SECONDS)
 
-// Function to move the frog right
-void moveRight(Object* frog, const Board* board, clock_t current_time) {
-    if (frog->y < board->cols - 2) {
-        bool noObstacle = true;
-        if (board->free_rows[frog->x].is_free == true) { // checking if there is no obstacle to the right
-            if (board->free_rows[frog->x].obstacles[frog->y + 1] == true) {
-                noObstacle = false;
-            }
-        }
-        if (noObstacle) {
-            frog->y++;
-            frog->last_key = 0;
-            frog->last_move_time = current_time;
-        }
-    }
-}
+#define RANKING_FILE "ranking.dat" // EVERY SCORE EVER, THE BEST ONES ARE SHOWN IN THE MENU
+#define RANKING_LINES 10
 
+#define PROFILE_FILE "frame_profile.csv" // THE TIMES OF THE PARTS OF THE FRAMES, WRITTEN ON EXIT
+#define PROFILE_REFRESH 0.5 // THE TIMES ON THE SCREEN ARE UPDATED THIS OFTEN (IN SECONDS)
 
-// Function to move the frog
-void moveObject(Object* frog, int ch, const Board* board) {
-    clock_t current_time = clock(); // Calulate the last time since last move
-    double passed_time = double(current_time - frog->last_move_time) / CLOCKS_PER_SEC;
+#define RECORDING_FILE "last_game.rec" // EVERY GAME IS SAVED HERE, jumping-frog --replay PLAYS IT AGAIN
+#define REPLAY_SEEK 5 // SECONDS SKIPPED BY THE ARROWS IN A REPLAY
+#define REPLAY_MAX_SPEED 64
 
-    if (ch == KEY_UP || ch == KEY_DOWN || ch == KEY_LEFT || ch == KEY_RIGHT) {
-        frog->last_key = ch; // Save the last key pressed
-        frog->on_friendly_car = false;
-    }
-
-    if (passed_time >= 1.0 / frog->speed) { // frog speed delay
-        if (frog->last_key == KEY_UP) {
-            moveUp(frog, board, current_time);
-        }
-        else if (frog->last_key == KEY_DOWN) {
-            moveDown(frog, board, current_time);
-        }
-        else if (frog->last_key == KEY_LEFT) {
-            moveLeft(frog, board, current_time);
-        }
-        else if (frog->last_key == KEY_RIGHT) {
-            moveRight(frog, board, current_time);
-        }
-    }
-}
-
-//***************************
-//* STORK RELATED FUNCTIONS *
-//***************************
-
-void initStork(Stork* stork, Object* frog) {
-    stork->x = NUMROWS - 1;
-    stork->y = 0;
-    stork->symbol = 'B';
-    stork->speed = frog->speed / 2;
-    stork->last_move_time = clock();
-}
-
-void updateStork(Stork* stork, Object* frog) {
-    clock_t current_time = clock();
-    double passed_time = double(current_time - stork->last_move_time) / CLOCKS_PER_SEC;
-    if (passed_time >= 1.0 / stork->speed) {
-        if (stork->y < frog->y) {
-            stork->y++;
-        }
-        else if (stork->y > frog->y) {
-            stork->y--;
-        }
-        if (stork->x > frog->x) {
-            stork->x--;
-        }
-        else if (stork->x < frog->x) {
-            stork->x++;
-        }
-        stork->last_move_time = current_time;
-    }
-}
-
-void drawStork(Stork* stork) {
-    attron(COLOR_PAIR(STORK_COLOR));
-    mvaddch(stork->x, stork->y, stork->symbol);
-    attroff(COLOR_PAIR(STORK_COLOR));
-}
-
-//*********************************
-//* GAME CURRENT STATUS FUNCTIONS *
-//*********************************
-
-// Function to check if the frog collided with a car or a stork
-bool checkCollision(Object* frog, Board* board, Stork* stork) {
-    //checking a collision with the car
-    for (int i = 0; i < board->num_roads; i++) {
-        if (frog->x == board->roads[i].car.x && frog->y == board->roads[i].car.y) {
-            if (board->roads[i].car.symbol == 'F' && board->friendly_on) {
-                frog->on_friendly_car = true;
-                frog->friendly_car_index = i;
-                return false;
-            }
-            else {
-                return true;
-            }
-        }
-    }
-    //checking a collsion with the stork
-    if (frog->x == stork->x && frog->y == stork->y) {
-        return true;
-    }
-    return false;
-}
-
-// Function to show the number of lanes passed
-void showLanesPassed(int x) {
-    mvprintw(NUMROWS / 2 + 1, NUMCOLS + 1, "Lanes passed: %d", x);
-}
-
-// Function to check if the frog reached the end
-bool checkWin(const Object* frog) {
-    return frog->x == 0;
-}
+#define REWIND_KEY 'r' // HOLDING IT DOWN TAKES THE GAME BACK
+#define REWIND_KEY_TIME 0.05 // SECONDS OF THE GAME TAKEN BACK BY EVERY r, A HELD KEY REPEATS ABOUT 30 TIMES PER SECOND
+#define REWIND_PAUSE 1.0 // THE GAME WAITS THIS LONG (IN REAL SECONDS) AFTER THE LAST r, SO IT DOESN'T GO ON BEFORE A HELD KEY REPEATS
 
 //************************
 //* GAME SCORE FUNCTIONS *
 //************************
 
-// Saving the calculated points to the file
-void saveScore(int points) {
-    FILE* file = fopen("ranking.txt", "a");
-    if (file == NULL) {
-        printf("Error: ranking.txt file not found!\n");
-        return;
-    }
-    fprintf(file, "%d\n", points);
-    fclose(file);
-}
-
-// Function that calculate points after the end of the game
-void CalculatePoints(Board* board, Object* frog, Timer* timer) {
-    int lanes_passed = frog->lanes_passed;
-    double time_passed = timer->current_time;
-    int win = checkWin(frog);
-    int bonus_for_win = (1 + win);
-    int minus_for_speed = 30 * frog->speed;
-    int points = 0;
-    points += (lanes_passed * 60 - 3 * time_passed) * bonus_for_win;
-    points -= minus_for_speed;
-    if (points < 0) {
-        points = 0;
-    }
-    saveScore(points);
-}
-
-// Deleting all the scores for the file to be clear for the next game
-void clearScoreFile() {
-    FILE* file = fopen("ranking.txt", "w");
-    if (file == NULL) {
-        printf("Error: ranking.txt file not found!\n");
+// Saving the score of the finished game to the leaderboard
+void saveScore(const Game* game) {
+    Leaderboard leaderboard;
+    if (!openLeaderboard(&leaderboard, RANKING_FILE)) {
+        printf("Error: can't open %s!\n", RANKING_FILE);
         return;
     }
-    fclose(file);
+    ScoreEntry entry;
+    makeScoreEntry(&entry, game);
+    addScore(&leaderboard, &entry);
+    closeLeaderboard(&leaderboard);
 }
 
 //******************
 //* MENU FUNCTIONS *
 //******************
 
+// Showing the best scores, only they are read from the leaderboard
 void showRanking(WINDOW* menu_win) {
     mvwprintw(menu_win, 1, 20, "Ranking");
-    FILE* file = fopen("ranking.txt", "r");
-    if (file == NULL) {
-        mvwprintw(menu_win, 2, 1, "No scores yet!");
+    Leaderboard leaderboard;
+    ScoreEntry best[RANKING_LINES];
+    int count = 0;
+    if (openLeaderboard(&leaderboard, RANKING_FILE)) {
+        count = topScores(&leaderboard, RANKING_LINES, best);
+        closeLeaderboard(&leaderboard);
+    }
+    if (count == 0) {
+        mvwprintw(menu_win, 2, 20, "No scores yet!");
         return;
     }
-    else {
-        int score;
-        int i = 2;
-        while (fscanf(file, "%d", &score) == 1) {
-            mvwprintw(menu_win, i, 20, "%d: %d points", i - 1, score);
-            i++;
+    for (int i = 0; i < count; i++) {
+        mvwprintw(menu_win, i + 2, 20, "%2d: %5d pts L%d", i + 1, best[i].points, best[i].level);
+        if (best[i].cars_per_road > 1) { // the scores of the boards with more cars are marked
+            wprintw(menu_win, " x%d", best[i].cars_per_road);
         }
     }
-    fclose(file);
 }
 
 void showInstructions(WINDOW* menu_win) {
@@ -757,110 +183,347 @@ int showMenu() {
 //* GAME MAIN LOOP *
 //******************
 
-void printEverything(Board* board, Object* frog, Stork* stork, Timer* timer) {
-    clear();
-    printBoard(board);
-    drawCars(board);
-    drawObject(frog);
-    drawStork(stork);
-    mvprintw(NUMROWS / 2 - 1, NUMCOLS + 1, "Level: %d ", frog->level);
-    showTimer(timer);
-    showLanesPassed(frog->lanes_passed);
-    mvprintw(NUMROWS / 2 + 2, NUMCOLS + 1, "Frog speed: %d ", frog->speed);
-    mvprintw(NUMROWS / 2 + 3, NUMCOLS + 1, "Car min/max speed: %d/%d ", board->car_min_speed, board->car_max_speed);
-    mvprintw(NUMROWS / 2 + 4, NUMCOLS + 1, "Jan Rudnicki, 203179");
-    mvprintw(LINES - 1, 0, "Press q to exit");
+// Function to translate the pressed key into the input of the engine
+int translateKey(int ch) {
+    if (ch == KEYBOARD_UP) {
+        return INPUT_UP;
+    }
+    else if (ch == KEYBOARD_DOWN) {
+        return INPUT_DOWN;
+    }
+    else if (ch == KEYBOARD_LEFT) {
+        return INPUT_LEFT;
+    }
+    else if (ch == KEYBOARD_RIGHT) {
+        return INPUT_RIGHT;
+    }
+    else if (ch == ' ') {
+        return INPUT_FRIENDLY;
+    }
+    return INPUT_NONE;
 }
 
-void GameLoop(Board* board, Object* frog, Timer* timer, Stork* stork) {
-    nodelay(stdscr, TRUE);
-    int ch;
-    while ((ch = getch()) != 'q') {
-        updateTimer(timer);
-        updateCars(board, frog);
-        moveObject(frog, ch, board);
-        updateStork(stork, frog);
-        if (int(timer->current_time) % 10 == 0 && int(timer->current_time) != 0) {
-            updateCarsSpeed(board);
-        }
-        if (ch == ' ') {
-            FriendlyOnOff(board);
-        }
-        printEverything(board, frog, stork, timer);
-        if (checkCollision(frog, board, stork)) {
-            mvprintw(NUMROWS / 2, NUMCOLS + 1, "Game Over! Press any key to return to menu.");
-            nodelay(stdscr, FALSE);
-            CalculatePoints(board, frog, timer);
-            getch();
-            break;
+// Function to check if the input moves the frog
+bool isMove(int input) {
+    return input == INPUT_UP || input == INPUT_DOWN || input == INPUT_LEFT || input == INPUT_RIGHT;
+}
+
+// Function to check if the engine still keeps a move that the frog couldn't make yet, a new key would replace it
+bool moveWaiting(const Game* game) {
+    const Object* frog = game->frog;
+    return frog->last_key != INPUT_NONE && frog->speed > 0 && game->now - frog->last_move_time < 1.0 / frog->speed;
+}
+
+// Function to show p50/p99/max of every phase of the frames under the text next to the board, or to clear them
+void showProfile(Renderer* renderer, const Profiler* profiler, bool visible) {
+    int row = renderer->rows / 2 + HUD_LINES;
+    char text[HUD_WIDTH];
+    snprintf(text, HUD_WIDTH, "%-8s %8s %8s %9s", "us", "p50", "p99", "max");
+    printText(renderer, row, renderer->cols + 1, visible ? text : "");
+    for (int phase = 0; phase < PHASE_COUNT; phase++) {
+        formatPhase(profiler, phase, text, HUD_WIDTH);
+        printText(renderer, row + 1 + phase, renderer->cols + 1, visible ? text : "");
+    }
+}
+
+// Function to play the game until it ends or q is pressed, returns false if it couldn't be started
+bool GameLoop(Game* game, Clock* clock, RenderBackend* backend, Profiler* profiler, bool* show_profile, RewindBuffer* rewind) {
+    KeyboardReader keyboard; // the keys are read on another thread, curses doesn't read them during the game
+    KeyQueue moves; // the arrows and spaces that the engine didn't get yet, at most one in a step
+    KeyEvent key;
+    if (!startKeyboard(&keyboard, STDIN_FILENO)) { // the game can't be played without its keys
+        clear();
+        mvprintw(0, 0, "Error: can't read the keys (%s)! Press any key to return to menu.", strerror(errno));
+        refresh();
+        nodelay(stdscr, FALSE);
+        getch();
+        return false;
+    }
+    bool quit = false;
+    bool profile_changed = *show_profile;
+    double last_profile = 0.0;
+    int profile_level = 0; // a new level clears the screen, the times are shown again at once
+    game->profiler = profiler;
+    double tick_length = 1.0 / game->config.tick_rate;
+    double accumulator = 0.0; // time of the clock that the engine still has to simulate
+    double max_catch_up = clock->speed > 1.0 ? MAX_CATCH_UP * clock->speed : MAX_CATCH_UP;
+    double previous_time = clockTime(clock);
+    double last_frame = realTime();
+    double rewind_end = 0.0; // real time until which the game waits after a rewind
+    long long rewind_steps = (long long)(REWIND_KEY_TIME * game->config.tick_rate + 0.5);
+    if (rewind_steps < 1) {
+        rewind_steps = 1;
+    }
+    clearRewind(rewind);
+    saveSnapshot(rewind, game);
+    initKeyQueue(&moves);
+    refresh(); // what curses still has to do goes to the screen now, not later over the game
+    Renderer renderer;
+    initRenderer(&renderer, backend);
+    printEverything(&renderer, game->board, game->frog, game->stork, game->timer);
+    showFrame(&renderer);
+    while (!quit) {
+        // sleeping until something moves or a key is pressed, a key waiting for the engine only waits for the next step
+        double sleep_time = tick_length - accumulator;
+        if (!peekKey(&moves, &key)) {
+            sleep_time = (nextEventTick(game) - game->tick) * tick_length - accumulator;
+            sleep_time = sleep_time < HUD_REFRESH ? sleep_time : HUD_REFRESH;
+        }
+        waitClock(clock, sleep_time, keyboardFd(&keyboard));
+        long long frame_start = profileClock();
+        int rewind_keys = 0;
+        while (nextKey(&keyboard, &key)) { // every key that came since the last frame
+            if (key.key == 'q') {
+                quit = true;
+            }
+            else if (key.key == REWIND_KEY) {
+                rewind_keys++;
+            }
+            else if (key.key == 'p') {
+                *show_profile = !*show_profile;
+                profile_changed = true;
+            }
+            else if (translateKey(key.key) != INPUT_NONE) {
+                key.time = clockTimeAt(clock, key.time); // the key goes to the step in which it was pressed
+                pushKey(&moves, &key);
+            }
         }
-        if (checkWin(frog)) {
-            if (frog->level == 3) {
-                CalculatePoints(board, frog, timer);
-                mvprintw(NUMROWS / 2, NUMCOLS + 1, "You Win! Press any key to return to menu.");
-                nodelay(stdscr, FALSE);
-                getch();
-                break;
+        profilePhase(profiler, PHASE_INPUT, frame_start);
+        double current_time = clockTime(clock);
+        accumulator += current_time - previous_time;
+        previous_time = current_time;
+        if (accumulator > max_catch_up) { // don't try to catch up after the process was stopped
+            accumulator = max_catch_up;
+        }
+        bool stepped = false;
+        if (rewind_keys > 0 && rewindGame(rewind, game, rewind_keys * rewind_steps) > 0) {
+            clearKeys(&moves); // a key pressed before the rewind doesn't count
+            rewind_end = realTime() + REWIND_PAUSE;
+            stepped = true;
+        }
+        if (realTime() < rewind_end) {
+            accumulator = 0.0;
+        }
+        while (game->status == GAME_RUNNING && accumulator + TIME_TOLERANCE >= tick_length) { // one step every 1 / tick_rate seconds
+            double step_end = current_time - accumulator + tick_length; // time of the clock at the end of this step
+            int input = INPUT_NONE;
+            if (peekKey(&moves, &key) && key.time <= step_end + TIME_TOLERANCE
+                && (!isMove(translateKey(key.key)) || !moveWaiting(game))) { // only an arrow waits for the move before it
+                popKey(&moves, &key);
+                input = translateKey(key.key);
             }
-            else {
-                initBoard(board, board->car_min_speed + 3, board->car_max_speed + 3);
-                frog->level++;
-                frog->x = board->rows - 1;
-                frog->y = board->cols / 2;
-                stork->x = NUMROWS - 1;
-                stork->y = 0;
+            step(game, input);
+            saveSnapshot(rewind, game);
+            accumulator -= tick_length;
+            stepped = true;
+        }
+        double real_time = realTime();
+        if (!stepped || (clock->speed != 1.0 && game->status == GAME_RUNNING && real_time - last_frame < FAST_FRAME_TIME)) {
+            continue;
+        }
+        last_frame = real_time;
+        long long time = profileClock();
+        printEverything(&renderer, game->board, game->frog, game->stork, game->timer);
+        if (profile_changed || (*show_profile && (renderer.level != profile_level || real_time - last_profile >= PROFILE_REFRESH))) {
+            showProfile(&renderer, profiler, *show_profile);
+            profile_changed = false;
+            profile_level = renderer.level;
+            last_profile = real_time;
+        }
+        time = profilePhase(profiler, PHASE_RENDER, time);
+        if (game->status == GAME_OVER) {
+            printText(&renderer, renderer.rows / 2, renderer.cols + 1, "Game Over! Press r to rewind or any other key to return to menu.");
+            showFrame(&renderer);
+            waitKey(&keyboard, &key);
+            if (key.key == REWIND_KEY && rewindGame(rewind, game, rewind_steps) > 0) {
+                clearKeys(&moves);
+                renderer.level = 0; // the whole screen is drawn again, without the message
+                printEverything(&renderer, game->board, game->frog, game->stork, game->timer);
+                showFrame(&renderer);
+                rewind_end = realTime() + REWIND_PAUSE;
+                continue;
             }
+            saveScore(game);
+            break;
         }
-        refresh();
+        if (game->status == GAME_WON) {
+            saveScore(game);
+            printText(&renderer, renderer.rows / 2, renderer.cols + 1, "You Win! Press any key to return to menu.");
+            showFrame(&renderer);
+            waitKey(&keyboard, &key);
+            break;
+        }
+        showFrame(&renderer);
+        profilePhase(profiler, PHASE_PRESENT, time);
+        profilePhase(profiler, PHASE_FRAME, frame_start);
     }
+    stopKeyboard(&keyboard);
+    game->profiler = NULL;
+    freeRenderer(&renderer);
+    return true;
 }
 
-//************************************
-//* READ PARAMETERS FROM CONFIG FILE *
-//************************************
+//***************
+//* REPLAY LOOP *
+//***************
 
-void openConfigFile(int* FROG_SPEED, int* CAR_MIN_SPEED, int* CAR_MAX_SPEED) {
-    FILE* configFile = fopen("config.txt", "r");
-    if (configFile == NULL) {
-        printf("Error: config.txt file not found!\n");
-        return;
-    }
-    char key[30];
-    int value;
-    for (int i = 0; i < 3; i++) {
-        if (fscanf(configFile, "%29s%d\n", key, &value) == 2) {
-            if (i == 0) {
-                *FROG_SPEED = value;
+// Function to show how the replay is played under the board
+void showReplayStatus(Renderer* renderer, const Replay* replay, double speed, bool paused) {
+    const Game* game = &replay->game;
+    char text[256];
+    int lines;
+    int cols;
+    renderer->backend->screen_size(renderer->backend, &lines, &cols);
+    snprintf(text, sizeof(text), "Replay %.2f/%.2f s, x%g%s%s  arrows: -/+%d s, +/-: speed, m: max, space: pause, q: exit",
+        game->now, double(replay->recording->end_tick) / game->config.tick_rate, speed, paused ? " paused" : "",
+        replayFinished(replay) ? " end" : "", REPLAY_SEEK);
+    printText(renderer, lines - 1, 0, text);
+}
+
+// Function to play a recorded game on the screen, faster or slower and with seeking
+void ReplayLoop(const Recording* recording, Clock* clock, RenderBackend* backend) {
+    nodelay(stdscr, TRUE);
+    Replay replay;
+    startReplay(&replay, recording);
+    Game* game = &replay.game;
+    double tick_length = 1.0 / game->config.tick_rate;
+    bool paused = false;
+    bool quit = false;
+    double accumulator = 0.0;
+    double previous_time = clockTime(clock);
+    refresh(); // what curses still has to do goes to the screen now, getch() would do it over the game
+    Renderer renderer;
+    initRenderer(&renderer, backend);
+    while (!quit) {
+        printEverything(&renderer, game->board, game->frog, game->stork, game->timer);
+        showReplayStatus(&renderer, &replay, clock->speed, paused);
+        showFrame(&renderer);
+        waitClock(clock, paused || replayFinished(&replay) ? clock->speed : tick_length - accumulator, STDIN_FILENO); // a real second when nothing moves
+        int ch;
+        while ((ch = getch()) != ERR) {
+            long long seek_ticks = (long long)REPLAY_SEEK * game->config.tick_rate;
+            if (ch == 'q') {
+                quit = true;
+            }
+            else if (ch == ' ') {
+                paused = !paused;
+            }
+            else if (ch == '+' && clock->speed < REPLAY_MAX_SPEED) {
+                setClockSpeed(clock, clock->speed * 2);
             }
-            else if (i == 1) {
-                *CAR_MIN_SPEED = value;
+            else if (ch == '-' && clock->speed > 1.0 / REPLAY_MAX_SPEED) {
+                setClockSpeed(clock, clock->speed / 2);
             }
-            else {
-                *CAR_MAX_SPEED = value;
+            else if (ch == 'm') { // as fast as the CPU allows, straight to the end
+                seekReplay(&replay, recording->end_tick);
             }
+            else if (ch == KEY_RIGHT) {
+                seekReplay(&replay, game->tick + seek_ticks);
+            }
+            else if (ch == KEY_LEFT) {
+                seekReplay(&replay, game->tick > seek_ticks ? game->tick - seek_ticks : 0);
+            }
+        }
+        double current_time = clockTime(clock);
+        accumulator += current_time - previous_time;
+        previous_time = current_time;
+        if (accumulator > MAX_CATCH_UP * clock->speed) {
+            accumulator = MAX_CATCH_UP * clock->speed;
+        }
+        if (paused) {
+            accumulator = 0.0;
+            continue;
+        }
+        while (!replayFinished(&replay) && accumulator >= tick_length) {
+            replayStep(&replay);
+            accumulator -= tick_length;
         }
     }
-    fclose(configFile);
+    freeRenderer(&renderer);
+    freeReplay(&replay);
 }
 
 //*****************
 //* MAIN FUNCTION *
 //*****************
 
-int main() {
+// Function to make the backend that draws the game, curses has to be started before
+void initBackend(RenderBackend* backend, const char* name) {
+    if (strcmp(name, "ansi") == 0) {
+        fflush(stdout); // curses writes to stdout too, what it has buffered goes first
+        initAnsiBackend(backend, STDOUT_FILENO);
+    }
+    else {
+        initCursesBackend(backend);
+    }
+}
+
+int main(int argc, char** argv) {
+    const char* replay_file = NULL;
+    const char* render_name = "curses";
+    double speed = 1.0; // seconds of the game per real second
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 < argc && strcmp(argv[i], "--replay") == 0) {
+            replay_file = argv[i + 1];
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "--render") == 0 && (strcmp(argv[i + 1], "curses") == 0 || strcmp(argv[i + 1], "ansi") == 0)) {
+            render_name = argv[i + 1];
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "--speed") == 0 && (strcmp(argv[i + 1], "max") == 0 || atof(argv[i + 1]) > 0)) {
+            speed = strcmp(argv[i + 1], "max") == 0 ? CLOCK_AS_FAST_AS_POSSIBLE : atof(argv[i + 1]);
+        }
+        else {
+            printf("Usage: jumping-frog [--replay FILE] [--render curses|ansi] [--speed X|max]\n");
+            return 1;
+        }
+    }
+    if (replay_file != NULL) {
+        Recording recording;
+        if (!loadRecording(&recording, replay_file)) {
+            return 1;
+        }
+        initscr();
+        noecho();
+        keypad(stdscr, TRUE);
+        curs_set(0);
+        createColorPairs();
+        RenderBackend backend;
+        initBackend(&backend, render_name);
+        Clock clock; // the replay is always shown, its speed changes with +/-
+        if (speed == CLOCK_AS_FAST_AS_POSSIBLE || speed > REPLAY_MAX_SPEED) {
+            speed = REPLAY_MAX_SPEED;
+        }
+        initClock(&clock, speed < 1.0 / REPLAY_MAX_SPEED ? 1.0 / REPLAY_MAX_SPEED : speed);
+        ReplayLoop(&recording, &clock, &backend);
+        freeBackend(&backend);
+        endwin();
+        freeRecording(&recording);
+        return 0;
+    }
+
     initscr();
     clear();
     noecho();
     keypad(stdscr, TRUE);
     curs_set(0);
-    srand(time(NULL));
-    clearScoreFile();
     createColorPairs();
+    RenderBackend backend; // the menu is always drawn with curses, the game with the chosen backend
+    initBackend(&backend, render_name);
+    Profiler* profiler = new Profiler; // the times of every game, saved on exit
+    initProfiler(profiler);
+    RewindBuffer* rewind = new RewindBuffer; // the snapshots of the game that is played, the memory is reused by every game
+    initRewind(rewind, REWIND_MEMORY, REWIND_MAX_SNAPSHOTS);
+    bool show_profile = false;
 
     // Initialize the parameters that will be read from the config file
     int FROG_SPEED;
     int CAR_MIN_SPEED;
     int CAR_MAX_SPEED;
+    int TICK_RATE = DEFAULT_TICK_RATE;
+    int BOARD_ROWS = 0;
+    int BOARD_COLS = 0;
+    int CARS_PER_ROAD = 1;
+    unsigned long long seed = (unsigned long long)time(NULL); // every game gets the next seed
 
     while (true) {
         // Show menu
@@ -870,35 +533,49 @@ int main() {
         }
 
         // Read parameters from config file
-        openConfigFile(&FROG_SPEED, &CAR_MIN_SPEED, &CAR_MAX_SPEED);
-
-        // Initialize the board
-        Board* board = new Board;
-        initBoard(board, CAR_MIN_SPEED, CAR_MAX_SPEED);
-        printBoard(board);
-
-        // Initialize the frog
-        Object* frog = new Object;
-        initObject(frog, board->rows - 1, board->cols / 2, 'O', FROG_SPEED);
-        drawObject(frog);
-
-        Stork* stork = new Stork;
-        initStork(stork, frog);
-
-        // Initialize the timer
-        Timer* timer = new Timer;
-        initTimer(timer);
+        openConfigFile(&FROG_SPEED, &CAR_MIN_SPEED, &CAR_MAX_SPEED, &TICK_RATE, &BOARD_ROWS, &BOARD_COLS, &CARS_PER_ROAD);
+
+        // Initialize the game, the board size comes from config.txt or from the terminal
+        GameConfig config;
+        config.frog_speed = FROG_SPEED;
+        config.car_min_speed = CAR_MIN_SPEED;
+        config.car_max_speed = CAR_MAX_SPEED;
+        config.rows = BOARD_ROWS >= 4 ? BOARD_ROWS : NUMROWS; // a bigger board than the terminal scrolls with the frog
+        config.cols = BOARD_COLS >= 3 ? BOARD_COLS : NUMCOLS;
+        config.tick_rate = TICK_RATE;
+        config.cars_per_road = CARS_PER_ROAD >= 1 ? CARS_PER_ROAD : 1;
+        config.background_levels = true; // no stall when the frog gets to the next level
+        config.seed = seed++;
+
+        Game* game = new Game;
+        initGame(game, &config);
+        Recording recording;
+        initRecording(&recording, &config);
+        game->recording = &recording;
 
         // Start the game loop
-        GameLoop(board, frog, timer, stork);
+        Clock clock;
+        initClock(&clock, speed);
+        if (GameLoop(game, &clock, &backend, profiler, &show_profile, rewind)) {
+            finishRecording(&recording, game);
+            saveRecording(&recording, RECORDING_FILE); // the last game that was played
+        }
+        freeRecording(&recording);
 
         // Free memory and refresh the screen
-        freeMemory(board, frog, timer, stork);
+        freeGame(game);
+        delete game;
         clear();
         refresh();
     }
 
-    clearScoreFile();
+    freeBackend(&backend);
     endwin();
+    if (!saveProfile(profiler, PROFILE_FILE)) {
+        printf("Error: can't save %s!\n", PROFILE_FILE);
+    }
+    delete profiler;
+    freeRewind(rewind);
+    delete rewind;
     return 0;
 }
@@ -0,0 +1,109 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - making the next level in advance
+    Version: 1.0
+
+    Every level has its own seed (levelSeed), so a level doesn't depend on
+    how the previous one was played and can be made before it is needed. The
+    pipeline has a second board: while a level is played the next one is made
+    on it, on a thread of the pipeline that waits for the next level to make,
+    so a level-up only wakes it up and creates no thread. When the frog wins
+    the level the two boards are swapped, and the old board is used for the
+    level after that. The headless tools and the batches of games make the
+    level on the same thread when it is taken, which gives exactly the same
+    levels and no work for the games that end before it.
+*/
+
+#include "pipeline.h"
+
+//**********************
+//* PIPELINE FUNCTIONS *
+//**********************
+
+// Function to make the levels that are asked for until the pipeline is freed, on the thread of the pipeline
+void levelWorker(LevelPipeline* pipeline) {
+    std::unique_lock<std::mutex> guard(pipeline->lock);
+    while (true) {
+        while (!pipeline->busy && !pipeline->stopping) {
+            pipeline->wake.wait(guard);
+        }
+        if (pipeline->stopping) {
+            return;
+        }
+        guard.unlock();
+        generateLevel(pipeline->board, &pipeline->config, pipeline->level); // nothing else touches them until it is done
+        guard.lock();
+        pipeline->busy = false;
+        pipeline->ready.notify_one();
+    }
+}
+
+// Function to make room for the second board, and start the thread that makes the levels if they are made
+// in the background. The thread is started once, a new level only wakes it up
+void initPipeline(LevelPipeline* pipeline, const GameConfig* config) {
+    pipeline->config = *config;
+    pipeline->board = new Board;
+    initArena(&pipeline->board->arena, boardMemorySize(config->rows, config->cols, config->cars_per_road));
+    pipeline->level = 0;
+    pipeline->busy = false;
+    pipeline->stopping = false;
+    if (config->background_levels) {
+        pipeline->worker = std::thread(levelWorker, pipeline);
+    }
+}
+
+// Function to wait until the level that is being made is ready
+void waitForLevel(LevelPipeline* pipeline) {
+    std::unique_lock<std::mutex> guard(pipeline->lock);
+    while (pipeline->busy) {
+        pipeline->ready.wait(guard);
+    }
+}
+
+// Function to forget the level that was made for the last game, the next levels are of the given config
+void resetPipeline(LevelPipeline* pipeline, const GameConfig* config) {
+    waitForLevel(pipeline);
+    pipeline->config = *config;
+    pipeline->level = 0;
+}
+
+// Function to start making the given level on the second board
+void prepareLevel(LevelPipeline* pipeline, int level) {
+    waitForLevel(pipeline);
+    pipeline->level = level;
+    if (level > LAST_LEVEL) {
+        return;
+    }
+    if (pipeline->worker.joinable()) {
+        std::lock_guard<std::mutex> guard(pipeline->lock);
+        pipeline->busy = true;
+        pipeline->wake.notify_one();
+    }
+}
+
+// Function to take the board of the next level, the old board is kept to make the level after it
+Board* takeLevel(LevelPipeline* pipeline, Board* old_board) {
+    waitForLevel(pipeline); // usually the level is ready long before
+    if (!pipeline->worker.joinable() && pipeline->level <= LAST_LEVEL) {
+        generateLevel(pipeline->board, &pipeline->config, pipeline->level); // most games never get to it
+    }
+    Board* board = pipeline->board;
+    pipeline->board = old_board;
+    pipeline->level = 0;
+    return board;
+}
+
+void freePipeline(LevelPipeline* pipeline) {
+    waitForLevel(pipeline);
+    if (pipeline->worker.joinable()) {
+        {
+            std::lock_guard<std::mutex> guard(pipeline->lock);
+            pipeline->stopping = true;
+        }
+        pipeline->wake.notify_one();
+        pipeline->worker.join();
+    }
+    freeArena(&pipeline->board->arena);
+    delete pipeline->board;
+    pipeline->board = NULL;
+}
@@ -0,0 +1,41 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - making the next level in advance
+    Version: 1.0
+*/
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "engine.h"
+
+//***********************
+//* DEFINING STRUCTURES *
+//***********************
+
+struct LevelPipeline { // The board of the next level, made while the current level is played
+    GameConfig config;
+    Board* board; // The next level, ready once the worker is done
+    int level; // Level that is on the board or being made, 0 for none
+    std::thread worker; // Makes the levels when config.background_levels is set, it lives as long as the pipeline
+    std::mutex lock;
+    std::condition_variable wake; // A level was asked for or the worker has to stop
+    std::condition_variable ready; // The worker finished the level
+    bool busy; // The worker is making the level
+    bool stopping;
+};
+
+//**********************
+//* PIPELINE FUNCTIONS *
+//**********************
+
+void initPipeline(LevelPipeline* pipeline, const GameConfig* config);
+void resetPipeline(LevelPipeline* pipeline, const GameConfig* config);
+void prepareLevel(LevelPipeline* pipeline, int level);
+Board* takeLevel(LevelPipeline* pipeline, Board* old_board);
+void freePipeline(LevelPipeline* pipeline);
+
+#endif
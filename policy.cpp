@@ -0,0 +1,76 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - frog that plays by itself
+    Version: 1.0
+
+    A simple greedy policy used by the batch tools: go up when it is safe,
+    dodge the cars when it is not.
+*/
+
+#include "policy.h"
+
+//*************************
+//* FROG POLICY FUNCTIONS *
+//*************************
+
+// Checking if a car is in the cell or is about to drive into it
+bool isDangerous(const Board* board, int x, int y) {
+    int road = board->occupancy.road_of_row[x];
+    if (road < 0) {
+        return false;
+    }
+    const uint64_t* cars = carBits(&board->occupancy, road);
+    int direction = board->roads[road].direction;
+    for (int distance = 0; distance <= 2; distance++) { // a car on the cell or coming to it
+        int car_y = y - distance * direction;
+        if (car_y >= 0 && car_y < board->cols - 1 && testBit(cars, car_y)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Checking if the frog can safely move to the given cell
+bool canGo(const Board* board, int x, int y) {
+    if (x < 0 || x >= board->rows || y < 0 || y > board->cols - 2) {
+        return false;
+    }
+    return !isObstacle(board, x, y) && !isDangerous(board, x, y);
+}
+
+// Function to choose the next input: go up when it is safe, dodge when it is not
+int greedyPolicy(const Game* game) {
+    const Board* board = game->board;
+    const Object* frog = game->frog;
+    if (game->now - frog->last_move_time < 1.0 / frog->speed) {
+        return INPUT_NONE; // the frog can't move yet
+    }
+    int x = frog->x;
+    int y = frog->y;
+    if (canGo(board, x - 1, y)) {
+        return INPUT_UP;
+    }
+    if (isDangerous(board, x, y)) {
+        if (canGo(board, x, y - 1)) {
+            return INPUT_LEFT;
+        }
+        if (canGo(board, x, y + 1)) {
+            return INPUT_RIGHT;
+        }
+        if (canGo(board, x + 1, y)) {
+            return INPUT_DOWN;
+        }
+        return INPUT_NONE;
+    }
+    if (x > 0 && isObstacle(board, x - 1, y)) { // walking to the nearest gap between the obstacles
+        for (int d = 1; d < board->cols; d++) {
+            if (y - d >= 0 && !isObstacle(board, x - 1, y - d)) {
+                return canGo(board, x, y - 1) ? INPUT_LEFT : INPUT_NONE;
+            }
+            if (y + d <= board->cols - 2 && !isObstacle(board, x - 1, y + d)) {
+                return canGo(board, x, y + 1) ? INPUT_RIGHT : INPUT_NONE;
+            }
+        }
+    }
+    return INPUT_NONE;
+}
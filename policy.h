@@ -0,0 +1,20 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - frog that plays by itself
+    Version: 1.0
+*/
+
+#ifndef POLICY_H
+#define POLICY_H
+
+#include "engine.h"
+
+//********************
+//* POLICY FUNCTIONS *
+//********************
+
+bool isDangerous(const Board* board, int x, int y);
+bool canGo(const Board* board, int x, int y);
+int greedyPolicy(const Game* game);
+
+#endif
@@ -0,0 +1,107 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - frame profiler
+    Version: 1.0
+
+    Every phase of a frame (reading the keys, every part of a step of the
+    engine, drawing and showing the frame) is timed with the monotonic clock
+    and counted in a histogram. The buckets of a histogram get wider with the
+    value (32 of them for every power of 2), so 9 kilobytes keep any time
+    from a nanosecond to minutes to about 3% and nothing is allocated while
+    the game runs. The percentiles are read from the buckets.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "profiler.h"
+
+//**********************
+//* DEFINING CONSTANTS *
+//**********************
+
+const char* PHASE_NAMES[PHASE_COUNT] = { "input", "timer", "cars", "frog", "stork", "speed", "render", "present", "frame" };
+
+//***********************
+//* HISTOGRAM FUNCTIONS *
+//***********************
+
+void initProfiler(Profiler* profiler) {
+    memset(profiler, 0, sizeof(Profiler));
+}
+
+const char* phaseName(int phase) {
+    return PHASE_NAMES[phase];
+}
+
+// Function to get the highest value that is counted in the given bucket
+long long bucketHighest(int bucket) {
+    if (bucket < HISTOGRAM_SUB_BUCKETS) {
+        return bucket;
+    }
+    int bit = bucket / HISTOGRAM_SUB_BUCKETS + HISTOGRAM_SUB_BITS - 1;
+    long long top = bucket % HISTOGRAM_SUB_BUCKETS + HISTOGRAM_SUB_BUCKETS;
+    return ((top + 1) << (bit - HISTOGRAM_SUB_BITS)) - 1;
+}
+
+// Function to get the value below which the given percent of the values are, never more than the maximum
+long long valueAtPercentile(const Histogram* histogram, double percentile) {
+    if (histogram->count == 0) {
+        return 0;
+    }
+    long long wanted = (long long)(histogram->count * percentile / 100.0 + 0.5);
+    if (wanted < 1) {
+        wanted = 1;
+    }
+    long long seen = 0;
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        seen += histogram->buckets[i];
+        if (seen >= wanted) {
+            long long value = bucketHighest(i);
+            return value < histogram->max ? value : histogram->max;
+        }
+    }
+    return histogram->max;
+}
+
+//*********************
+//* SHOWING THE TIMES *
+//*********************
+
+// Function to write one line of the overlay: the phase and its p50, p99 and max in microseconds
+void formatPhase(const Profiler* profiler, int phase, char* text, int size) {
+    const Histogram* histogram = &profiler->phases[phase];
+    snprintf(text, size, "%-8s %8.1f %8.1f %9.1f", phaseName(phase), valueAtPercentile(histogram, 50) / 1000.0,
+             valueAtPercentile(histogram, 99) / 1000.0, histogram->max / 1000.0);
+}
+
+// Function to write the percentiles of every phase and the buckets that aren't empty to the file
+bool saveProfile(const Profiler* profiler, const char* file_name) {
+    FILE* file = fopen(file_name, "w");
+    if (file == NULL) {
+        return false;
+    }
+    const double percentiles[] = { 50, 90, 99, 99.9, 99.99 };
+    fprintf(file, "# times in microseconds\n");
+    fprintf(file, "phase,count,mean,p50,p90,p99,p99.9,p99.99,max\n");
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        const Histogram* histogram = &profiler->phases[p];
+        fprintf(file, "%s,%lld,%.3f", phaseName(p), histogram->count,
+                histogram->count > 0 ? double(histogram->total) / histogram->count / 1000.0 : 0.0);
+        for (int i = 0; i < int(sizeof(percentiles) / sizeof(percentiles[0])); i++) {
+            fprintf(file, ",%.3f", valueAtPercentile(histogram, percentiles[i]) / 1000.0);
+        }
+        fprintf(file, ",%.3f\n", histogram->max / 1000.0);
+    }
+    fprintf(file, "\n# the histograms, every bucket counts the times up to its value\n");
+    fprintf(file, "phase,up_to_us,count\n");
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        const Histogram* histogram = &profiler->phases[p];
+        for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+            if (histogram->buckets[i] > 0) {
+                fprintf(file, "%s,%.3f,%lld\n", phaseName(p), bucketHighest(i) / 1000.0, histogram->buckets[i]);
+            }
+        }
+    }
+    fclose(file);
+    return true;
+}
@@ -0,0 +1,107 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - frame profiler
+    Version: 1.0
+*/
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stddef.h>
+#include <time.h>
+
+//**********************
+//* DEFINING CONSTANTS *
+//**********************
+
+#define PHASE_INPUT 0 // THE PARTS OF A FRAME THAT ARE TIMED
+#define PHASE_TIMER 1
+#define PHASE_CARS 2
+#define PHASE_FROG 3
+#define PHASE_STORK 4
+#define PHASE_SPEED 5
+#define PHASE_RENDER 6
+#define PHASE_PRESENT 7
+#define PHASE_FRAME 8 // FROM THE END OF THE WAIT TO THE FRAME ON THE SCREEN
+#define PHASE_COUNT 9
+
+#define HISTOGRAM_SUB_BITS 5 // EVERY POWER OF 2 IS SPLIT INTO 32 BUCKETS, SO A VALUE IS KNOWN TO ABOUT 3%
+#define HISTOGRAM_SUB_BUCKETS (1 << HISTOGRAM_SUB_BITS)
+#define HISTOGRAM_MAX_BIT 40 // LONGER THAN 2^40 NANOSECONDS (18 MINUTES) COUNTS AS 2^40
+#define HISTOGRAM_BUCKETS ((HISTOGRAM_MAX_BIT - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_BUCKETS)
+
+//***********************
+//* DEFINING STRUCTURES *
+//***********************
+
+struct Histogram { // Nanoseconds in buckets that grow with the value, like in HdrHistogram
+    long long count;
+    long long total;
+    long long max;
+    long long buckets[HISTOGRAM_BUCKETS];
+};
+
+struct Profiler { // Times of the phases of the frames, a histogram for every phase
+    Histogram phases[PHASE_COUNT];
+};
+
+//**********************
+//* RECORDING THE TIME *
+//**********************
+
+inline long long profileClock() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Bucket of the value: the values below 32 have their own buckets, above that
+// every power of 2 has 32 buckets
+inline int histogramBucket(long long value) {
+    if (value < HISTOGRAM_SUB_BUCKETS) {
+        return value < 0 ? 0 : (int)value;
+    }
+    if (value >= (1LL << HISTOGRAM_MAX_BIT)) {
+        value = (1LL << HISTOGRAM_MAX_BIT) - 1;
+    }
+    int bit = 63 - __builtin_clzll((unsigned long long)value);
+    int top = (int)(value >> (bit - HISTOGRAM_SUB_BITS)); // 32 ... 63
+    return (bit - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_BUCKETS + top - HISTOGRAM_SUB_BUCKETS;
+}
+
+inline void recordValue(Histogram* histogram, long long value) {
+    histogram->buckets[histogramBucket(value)]++;
+    histogram->count++;
+    histogram->total += value;
+    if (value > histogram->max) {
+        histogram->max = value;
+    }
+}
+
+// The time to pass to profilePhase, 0 if nothing is measured
+inline long long profileStart(Profiler* profiler) {
+    return profiler != NULL ? profileClock() : 0;
+}
+
+// Records the time from start to now as the given phase, returns now so the next phase starts there
+inline long long profilePhase(Profiler* profiler, int phase, long long start) {
+    if (profiler == NULL) {
+        return 0;
+    }
+    long long now = profileClock();
+    recordValue(&profiler->phases[phase], now - start);
+    return now;
+}
+
+//**********************
+//* PROFILER FUNCTIONS *
+//**********************
+
+void initProfiler(Profiler* profiler);
+const char* phaseName(int phase);
+long long bucketHighest(int bucket);
+long long valueAtPercentile(const Histogram* histogram, double percentile);
+void formatPhase(const Profiler* profiler, int phase, char* text, int size);
+bool saveProfile(const Profiler* profiler, const char* file_name);
+
+#endif
@@ -0,0 +1,596 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - drawing the game
+    Version: 1.0
+
+    Only a view of the board that fits the terminal is drawn, it follows the
+    frog. The level (start/end rows, roads, obstacles) in the view is made
+    into cells when the level starts or the view moves. Every frame only the
+    cells under the cars, the frog and the stork (now and in the previous
+    frame) are compared with what is on the screen, and only the ones that
+    changed are sent to the backend. So drawing depends on the size of the
+    view, not on the size of the board.
+
+    The ANSI backend keeps its own copy of the terminal. The changes of a
+    frame go to a second copy, and when the frame is shown only the cells that
+    differ are turned into escape sequences, all of them in a single write().
+    The curses backend is in render_curses.cpp, so nothing here needs curses.
+*/
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include "render.h"
+
+//**********************
+//* DEFINING CONSTANTS *
+//**********************
+
+#define ANSI_REWRITE_GAP 4 // A GAP OF UNCHANGED CELLS THIS SHORT IS WRITTEN AGAIN, IT IS SHORTER THAN MOVING THE CURSOR
+
+//***********************
+//* DEFINING STRUCTURES *
+//***********************
+
+struct AnsiScreen { // The state of the ANSI backend
+    int fd; // The terminal
+    int lines;
+    int cols;
+    Cell* front; // What is on the terminal
+    Cell* back; // What the frame that is being drawn looks like
+    bool* dirty_rows; // The rows of back that were drawn on since the last frame
+    bool cleared; // The terminal has to be cleared before the next frame
+    char* output; // The escape sequences of one frame
+    int output_size;
+};
+
+struct NullScreen { // The state of the backend that draws nothing, only its size
+    int lines;
+    int cols;
+};
+
+// The ANSI colors (foreground, background) of the color pairs, the same as the curses ones in createColorPairs
+const int ANSI_COLORS[][2] = {
+    { 39, 49 }, // the default colors
+    { 32, 42 }, // END_COLOR
+    { 33, 47 }, // FREE_COLOR
+    { 30, 47 }, // OBSTACLE_COLOR
+    { 31, 41 }, // START_COLOR
+    { 34, 44 }, // FROG_COLOR
+    { 37, 42 }, // FRIENDLY_COLOR
+    { 37, 41 }, // STORK_COLOR
+};
+
+//****************
+//* ANSI BACKEND *
+//****************
+
+// Function to ask the terminal for its size, LINES and COLUMNS are used when it isn't a terminal
+void terminalSize(int fd, int* lines, int* cols) {
+    winsize size;
+    if (ioctl(fd, TIOCGWINSZ, &size) == 0 && size.ws_row > 0 && size.ws_col > 0) {
+        *lines = size.ws_row;
+        *cols = size.ws_col;
+        return;
+    }
+    const char* env_lines = getenv("LINES");
+    const char* env_cols = getenv("COLUMNS");
+    *lines = env_lines != NULL && atoi(env_lines) > 0 ? atoi(env_lines) : DEFAULT_SCREEN_LINES;
+    *cols = env_cols != NULL && atoi(env_cols) > 0 ? atoi(env_cols) : DEFAULT_SCREEN_COLS;
+}
+
+void freeAnsiBuffers(AnsiScreen* screen) {
+    delete[] screen->front;
+    delete[] screen->back;
+    delete[] screen->dirty_rows;
+    delete[] screen->output;
+}
+
+// Function to get the size of the terminal, the copies of it are made again when it changed
+void ansiScreenSize(RenderBackend* backend, int* lines, int* cols) {
+    AnsiScreen* screen = (AnsiScreen*)backend->data;
+    terminalSize(screen->fd, lines, cols);
+    if (*lines == screen->lines && *cols == screen->cols) {
+        return;
+    }
+    freeAnsiBuffers(screen);
+    screen->lines = *lines;
+    screen->cols = *cols;
+    screen->front = new Cell[*lines * *cols];
+    screen->back = new Cell[*lines * *cols];
+    screen->dirty_rows = new bool[*lines];
+    screen->output_size = *lines * *cols * 24 + 64; // the most a cell takes is a cursor move, two colors and itself
+    screen->output = new char[screen->output_size];
+    backend->clear(backend);
+}
+
+void ansiClear(RenderBackend* backend) {
+    AnsiScreen* screen = (AnsiScreen*)backend->data;
+    for (int i = 0; i < screen->lines * screen->cols; i++) {
+        screen->back[i] = makeCell(' ', 0);
+        screen->front[i] = makeCell(' ', 0); // what the terminal looks like after it is cleared
+    }
+    for (int i = 0; i < screen->lines; i++) {
+        screen->dirty_rows[i] = false;
+    }
+    screen->cleared = true;
+}
+
+void ansiPutCell(RenderBackend* backend, int row, int col, Cell cell) {
+    AnsiScreen* screen = (AnsiScreen*)backend->data;
+    if (row < 0 || row >= screen->lines || col < 0 || col >= screen->cols) {
+        return;
+    }
+    screen->back[row * screen->cols + col] = cell;
+    screen->dirty_rows[row] = true;
+}
+
+void ansiPutText(RenderBackend* backend, int row, int col, const char* text) {
+    AnsiScreen* screen = (AnsiScreen*)backend->data;
+    if (row < 0 || row >= screen->lines) {
+        return;
+    }
+    for (int j = col < 0 ? 0 : col; j < screen->cols; j++) {
+        char symbol = *text != '\0' ? *text++ : ' ';
+        screen->back[row * screen->cols + j] = makeCell(symbol, 0);
+    }
+    screen->dirty_rows[row] = true;
+}
+
+// Function to write the whole text, the terminal may take it in parts
+void writeAll(int fd, const char* text, int length) {
+    while (length > 0) {
+        ssize_t written = write(fd, text, length);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return;
+        }
+        text += written;
+        length -= written;
+    }
+}
+
+// Function to write the cell where the cursor is, with its colors if they aren't the current ones. Returns the length
+int putAnsiCell(char* out, Cell cell, int* color) {
+    int length = 0;
+    if (cell.color != *color) {
+        *color = cell.color;
+        length += sprintf(out, "\x1b[%d;%dm", ANSI_COLORS[(unsigned char)cell.color][0], ANSI_COLORS[(unsigned char)cell.color][1]);
+    }
+    out[length++] = cell.symbol;
+    return length;
+}
+
+// Function to turn the cells that differ from the terminal into escape sequences and write them at once
+void ansiPresent(RenderBackend* backend) {
+    AnsiScreen* screen = (AnsiScreen*)backend->data;
+    char* out = screen->output;
+    int length = 0;
+    if (screen->cleared) {
+        length += sprintf(out + length, "\x1b[0m\x1b[?25l\x1b[2J");
+        screen->cleared = false;
+    }
+    int color = 0; // every frame ends with the default colors
+    int cursor_row = -1;
+    int cursor_col = -1;
+    for (int i = 0; i < screen->lines; i++) {
+        if (!screen->dirty_rows[i]) {
+            continue;
+        }
+        screen->dirty_rows[i] = false;
+        Cell* back = &screen->back[i * screen->cols];
+        Cell* front = &screen->front[i * screen->cols];
+        for (int j = 0; j < screen->cols; j++) {
+            if (sameCell(back[j], front[j])) {
+                continue;
+            }
+            if (cursor_row == i && cursor_col < j && j - cursor_col <= ANSI_REWRITE_GAP) {
+                for (int k = cursor_col; k < j; k++) {
+                    length += putAnsiCell(out + length, back[k], &color);
+                }
+            }
+            else if (cursor_row != i || cursor_col != j) {
+                length += sprintf(out + length, "\x1b[%d;%dH", i + 1, j + 1);
+            }
+            length += putAnsiCell(out + length, back[j], &color);
+            front[j] = back[j];
+            cursor_row = i;
+            cursor_col = j + 1;
+        }
+    }
+    if (length > 0) {
+        if (color > 0) {
+            length += sprintf(out + length, "\x1b[0m");
+        }
+        writeAll(screen->fd, out, length);
+    }
+}
+
+void ansiRelease(RenderBackend* backend) {
+    AnsiScreen* screen = (AnsiScreen*)backend->data;
+    freeAnsiBuffers(screen);
+    delete screen;
+}
+
+// Function to make a backend that writes escape sequences to the given terminal
+void initAnsiBackend(RenderBackend* backend, int fd) {
+    AnsiScreen* screen = new AnsiScreen;
+    screen->fd = fd;
+    screen->lines = 0;
+    screen->cols = 0;
+    screen->front = NULL;
+    screen->back = NULL;
+    screen->dirty_rows = NULL;
+    screen->cleared = true;
+    screen->output = NULL;
+    screen->output_size = 0;
+    backend->data = screen;
+    backend->screen_size = ansiScreenSize;
+    backend->clear = ansiClear;
+    backend->put_cell = ansiPutCell;
+    backend->put_text = ansiPutText;
+    backend->present = ansiPresent;
+    backend->release = ansiRelease;
+    int lines;
+    int cols;
+    ansiScreenSize(backend, &lines, &cols);
+}
+
+//****************
+//* NULL BACKEND *
+//****************
+
+void nullScreenSize(RenderBackend* backend, int* lines, int* cols) {
+    NullScreen* screen = (NullScreen*)backend->data;
+    *lines = screen->lines;
+    *cols = screen->cols;
+}
+
+void nullClear(RenderBackend*) {
+}
+
+void nullPutCell(RenderBackend*, int, int, Cell) {
+}
+
+void nullPutText(RenderBackend*, int, int, const char*) {
+}
+
+void nullPresent(RenderBackend*) {
+}
+
+void nullRelease(RenderBackend* backend) {
+    delete (NullScreen*)backend->data;
+}
+
+// Function to make a backend that draws nothing, so only the work of the renderer is left
+void initNullBackend(RenderBackend* backend, int lines, int cols) {
+    NullScreen* screen = new NullScreen;
+    screen->lines = lines;
+    screen->cols = cols;
+    backend->data = screen;
+    backend->screen_size = nullScreenSize;
+    backend->clear = nullClear;
+    backend->put_cell = nullPutCell;
+    backend->put_text = nullPutText;
+    backend->present = nullPresent;
+    backend->release = nullRelease;
+}
+
+void freeBackend(RenderBackend* backend) {
+    backend->release(backend);
+    backend->data = NULL;
+}
+
+//*****************************
+//* RENDERER MEMORY FUNCTIONS *
+//*****************************
+
+void initRenderer(Renderer* renderer, RenderBackend* backend) {
+    renderer->backend = backend;
+    renderer->rows = 0;
+    renderer->cols = 0;
+    renderer->top = 0;
+    renderer->left = 0;
+    renderer->board_rows = 0;
+    renderer->board_cols = 0;
+    renderer->level = 0;
+    renderer->level_cells = NULL;
+    renderer->frame = NULL;
+    renderer->screen = NULL;
+    renderer->drawn = NULL;
+    renderer->dirty = NULL;
+    renderer->num_drawn = 0;
+    renderer->num_dirty = 0;
+    renderer->all_dirty = false;
+    renderer->capacity = 0;
+}
+
+void freeRenderer(Renderer* renderer) {
+    delete[] renderer->level_cells;
+    delete[] renderer->frame;
+    delete[] renderer->screen;
+    delete[] renderer->drawn;
+    delete[] renderer->dirty;
+    initRenderer(renderer, renderer->backend);
+}
+
+// Function to make the view as big as the terminal allows (next to the text) and the cell arrays fit it
+void resizeRenderer(Renderer* renderer, const Board* board) {
+    int lines;
+    int columns;
+    renderer->backend->screen_size(renderer->backend, &lines, &columns);
+    int rows = lines - 1 < board->rows ? lines - 1 : board->rows; // the last line is for "Press q to exit"
+    int cols = columns - HUD_WIDTH - 1 < board->cols - 1 ? columns - HUD_WIDTH - 1 : board->cols - 1;
+    if (rows < 1) {
+        rows = 1;
+    }
+    if (cols < 1) {
+        cols = 1;
+    }
+    renderer->board_rows = board->rows;
+    renderer->board_cols = board->cols;
+    int capacity = rows * board->cars_per_road + 2; // the cars of every row of the view, the frog and the stork
+    if (renderer->rows != rows || renderer->cols != cols) {
+        delete[] renderer->level_cells;
+        delete[] renderer->frame;
+        delete[] renderer->screen;
+        renderer->rows = rows;
+        renderer->cols = cols;
+        renderer->level_cells = new Cell[rows * cols];
+        renderer->frame = new Cell[rows * cols];
+        renderer->screen = new Cell[rows * cols];
+    }
+    if (renderer->capacity < capacity) {
+        delete[] renderer->drawn;
+        delete[] renderer->dirty;
+        renderer->capacity = capacity;
+        renderer->drawn = new int[capacity];
+        renderer->dirty = new int[capacity * 2];
+    }
+}
+
+//***************************
+//* BOARD RELATED FUNCTIONS *
+//***************************
+
+// Function to get the cell of the level (without the moving things) in the given place of the board
+Cell levelCell(const Board* board, int x, int y) {
+    if (x == 0) {
+        return makeCell(board->grid[x][y], END_COLOR);
+    }
+    if (x == board->rows - 1) {
+        return makeCell(board->grid[x][y], START_COLOR);
+    }
+    if (board->occupancy.road_of_row[x] >= 0) {
+        return makeCell('-', 0);
+    }
+    if (isObstacle(board, x, y)) {
+        return makeCell('X', OBSTACLE_COLOR);
+    }
+    return makeCell(board->grid[x][y], FREE_COLOR);
+}
+
+// Function to move the view so the frog is at least VIEW_MARGIN cells from its edge, returns true if it moved
+bool followFrog(Renderer* renderer, const Board* board, const Object* frog) {
+    int top = renderer->top;
+    int left = renderer->left;
+    int margin_rows = VIEW_MARGIN * 2 < renderer->rows ? VIEW_MARGIN : (renderer->rows - 1) / 2;
+    int margin_cols = VIEW_MARGIN * 2 < renderer->cols ? VIEW_MARGIN : (renderer->cols - 1) / 2;
+    if (frog->x < top + margin_rows) {
+        top = frog->x - margin_rows;
+    }
+    else if (frog->x > top + renderer->rows - 1 - margin_rows) {
+        top = frog->x - renderer->rows + 1 + margin_rows;
+    }
+    if (frog->y < left + margin_cols) {
+        left = frog->y - margin_cols;
+    }
+    else if (frog->y > left + renderer->cols - 1 - margin_cols) {
+        left = frog->y - renderer->cols + 1 + margin_cols;
+    }
+    // the view never goes past the edges of the board
+    if (top > board->rows - renderer->rows) {
+        top = board->rows - renderer->rows;
+    }
+    if (left > board->cols - 1 - renderer->cols) {
+        left = board->cols - 1 - renderer->cols;
+    }
+    if (top < 0) {
+        top = 0;
+    }
+    if (left < 0) {
+        left = 0;
+    }
+    bool moved = top != renderer->top || left != renderer->left;
+    renderer->top = top;
+    renderer->left = left;
+    return moved;
+}
+
+// Function to make the cells of the level in the view, called when the level starts or the view moves
+void printView(Renderer* renderer, const Board* board) {
+    for (int i = 0; i < renderer->rows; i++) {
+        Cell* row = &renderer->level_cells[i * renderer->cols];
+        for (int j = 0; j < renderer->cols; j++) {
+            row[j] = levelCell(board, renderer->top + i, renderer->left + j);
+        }
+    }
+    memcpy(renderer->frame, renderer->level_cells, renderer->rows * renderer->cols * sizeof(Cell));
+    renderer->num_drawn = 0; // the moving things are drawn again on the new cells
+    renderer->num_dirty = 0;
+    renderer->all_dirty = true;
+}
+
+// Function to clear the screen for a new level, nothing that was on it is known anymore
+void printBoard(Renderer* renderer, const Board* board, int level) {
+    resizeRenderer(renderer, board);
+    renderer->backend->clear(renderer->backend);
+    for (int i = 0; i < renderer->rows * renderer->cols; i++) {
+        renderer->screen[i] = makeCell(' ', 0);
+    }
+    for (int i = 0; i < HUD_LINES; i++) {
+        renderer->hud[i][0] = '\0';
+    }
+    int lines;
+    int columns;
+    renderer->backend->screen_size(renderer->backend, &lines, &columns);
+    renderer->backend->put_text(renderer->backend, lines - 1, 0, "Press q to exit, p to show the frame times, hold r to rewind");
+    renderer->level = level;
+}
+
+// Function to put a moving thing on the frame, the coordinates are the ones of the board
+void drawCell(Renderer* renderer, int x, int y, char symbol, char color) {
+    x -= renderer->top;
+    y -= renderer->left;
+    if (x < 0 || x >= renderer->rows || y < 0 || y >= renderer->cols) {
+        return; // not in the view
+    }
+    int index = x * renderer->cols + y;
+    renderer->frame[index] = makeCell(symbol, color);
+    renderer->drawn[renderer->num_drawn++] = index;
+    renderer->dirty[renderer->num_dirty++] = index;
+}
+
+void flushCell(Renderer* renderer, int index) {
+    Cell cell = renderer->frame[index];
+    if (!sameCell(cell, renderer->screen[index])) {
+        renderer->backend->put_cell(renderer->backend, index / renderer->cols, index % renderer->cols, cell);
+        renderer->screen[index] = cell;
+    }
+}
+
+// Function to send the changed cells to the backend
+void flushCells(Renderer* renderer) {
+    if (renderer->all_dirty) {
+        for (int i = 0; i < renderer->rows * renderer->cols; i++) {
+            flushCell(renderer, i);
+        }
+        renderer->all_dirty = false;
+    }
+    else {
+        for (int i = 0; i < renderer->num_dirty; i++) {
+            flushCell(renderer, renderer->dirty[i]);
+        }
+    }
+    renderer->num_dirty = 0;
+}
+
+//*************************
+//* CAR RELATED FUNCTIONS *
+//*************************
+
+// Function to draw the cars in the view, only the rows of the view are looked at
+void drawCars(Renderer* renderer, const Board* board) {
+    const CarStore* cars = &board->cars;
+    for (int x = renderer->top; x < renderer->top + renderer->rows; x++) {
+        int road = board->occupancy.road_of_row[x];
+        if (road < 0) {
+            continue;
+        }
+        for (int j = 0; j < board->roads[road].count; j++) {
+            int i = laneSlot(board, road, j);
+            if (cars->symbol[i] == 'F' && board->friendly_on) {
+                drawCell(renderer, cars->x[i], cars->y[i], cars->symbol[i], FRIENDLY_COLOR);
+            }
+            else {
+                drawCell(renderer, cars->x[i], cars->y[i], cars->symbol[i], 0);
+            }
+        }
+    }
+}
+
+//**************************
+//* FROG RELATED FUNCTIONS *
+//**************************
+
+// Function to draw the frog
+void drawObject(Renderer* renderer, const Object* frog) {
+    drawCell(renderer, frog->x, frog->y, frog->symbol, FROG_COLOR);
+}
+
+//***************************
+//* STORK RELATED FUNCTIONS *
+//***************************
+
+void drawStork(Renderer* renderer, const Stork* stork) {
+    drawCell(renderer, stork->x, stork->y, stork->symbol, STORK_COLOR);
+}
+
+//*******************
+//* TEXT NEXT TO IT *
+//*******************
+
+// Function to print a line of text next to the board, if it is different than the last time
+void printHudLine(Renderer* renderer, int line, const char* text) {
+    if (strcmp(renderer->hud[line], text) == 0) {
+        return;
+    }
+    strcpy(renderer->hud[line], text);
+    renderer->backend->put_text(renderer->backend, renderer->rows / 2 - 1 + line, renderer->cols + 1, text);
+}
+
+void showTimer(Renderer* renderer, const Timer* timer) {
+    char text[HUD_WIDTH];
+    snprintf(text, HUD_WIDTH, "Time: %.2f s", timer->current_time);
+    printHudLine(renderer, 1, text);
+}
+
+// Function to show the number of lanes passed
+void showLanesPassed(Renderer* renderer, int x) {
+    char text[HUD_WIDTH];
+    snprintf(text, HUD_WIDTH, "Lanes passed: %d", x);
+    printHudLine(renderer, 2, text);
+}
+
+//******************
+//* GAME MAIN LOOP *
+//******************
+
+void printEverything(Renderer* renderer, Board* board, Object* frog, Stork* stork, Timer* timer) {
+    bool new_level = renderer->level != frog->level || renderer->board_rows != board->rows || renderer->board_cols != board->cols;
+    if (new_level) {
+        printBoard(renderer, board, frog->level);
+    }
+    if (followFrog(renderer, board, frog) || new_level) {
+        printView(renderer, board);
+    }
+    else { // taking the moving things of the last frame off the view
+        for (int i = 0; i < renderer->num_drawn; i++) {
+            int index = renderer->drawn[i];
+            renderer->frame[index] = renderer->level_cells[index];
+            renderer->dirty[renderer->num_dirty++] = index;
+        }
+        renderer->num_drawn = 0;
+    }
+
+    drawCars(renderer, board);
+    drawObject(renderer, frog);
+    drawStork(renderer, stork);
+    flushCells(renderer);
+
+    char text[HUD_WIDTH];
+    snprintf(text, HUD_WIDTH, "Level: %d ", frog->level);
+    printHudLine(renderer, 0, text);
+    showTimer(renderer, timer);
+    showLanesPassed(renderer, frog->lanes_passed);
+    snprintf(text, HUD_WIDTH, "Frog speed: %d ", frog->speed);
+    printHudLine(renderer, 3, text);
+    snprintf(text, HUD_WIDTH, "Car min/max speed: %d/%d ", board->car_min_speed, board->car_max_speed);
+    printHudLine(renderer, 4, text);
+    printHudLine(renderer, 5, "Jan Rudnicki, 203179");
+}
+
+// Function to print a message on the screen, e.g. at the end of the game, the rest of the line is cleared
+void printText(Renderer* renderer, int row, int col, const char* text) {
+    renderer->backend->put_text(renderer->backend, row, col, text);
+}
+
+// Function to show everything that was drawn since the last frame
+void showFrame(Renderer* renderer) {
+    renderer->backend->present(renderer->backend);
+}
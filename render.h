@@ -0,0 +1,101 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - drawing the game
+    Version: 1.0
+
+    The renderer works out what changed on the screen, a backend draws it.
+    There are three backends: curses, raw ANSI escape sequences written with
+    one write() per frame, and one that draws nothing (for the benchmarks).
+*/
+
+#ifndef RENDER_H
+#define RENDER_H
+
+#include "engine.h"
+
+//**********************
+//* DEFINING CONSTANTS *
+//**********************
+
+#define END_COLOR 1 // DEFINING COLORS
+#define FREE_COLOR 2 // DEFINE THE COLOR OF THE FREE AREA
+#define OBSTACLE_COLOR 3
+#define START_COLOR 4 // DEFINE THE COLOR OF THE STARTING AREA
+#define FROG_COLOR 5
+#define FRIENDLY_COLOR 6 // COLOR OF A FRIENDLY CAR THAT IS TURNED ON
+#define STORK_COLOR 7
+
+#define HUD_LINES 6 // NUMBER OF TEXT LINES NEXT TO THE BOARD
+#define HUD_WIDTH 64
+#define VIEW_MARGIN 4 // THE VIEW MOVES WHEN THE FROG IS CLOSER THAN THIS TO ITS EDGE
+#define DEFAULT_SCREEN_LINES 24 // THE SIZE OF A TERMINAL THAT DOESN'T TELL ITS SIZE
+#define DEFAULT_SCREEN_COLS 80
+
+//***********************
+//* DEFINING STRUCTURES *
+//***********************
+
+struct Cell { // One character on the screen
+    char symbol;
+    char color; // Color pair, 0 for the default colors
+};
+
+inline Cell makeCell(char symbol, char color) {
+    Cell cell;
+    cell.symbol = symbol;
+    cell.color = color;
+    return cell;
+}
+
+inline bool sameCell(Cell a, Cell b) {
+    return a.symbol == b.symbol && a.color == b.color;
+}
+
+struct RenderBackend { // Draws on the screen, the renderer only gives it the cells and the text that changed
+    void* data; // The backend's own state
+    void (*screen_size)(RenderBackend* backend, int* lines, int* cols);
+    void (*clear)(RenderBackend* backend); // Nothing that was on the screen is known anymore
+    void (*put_cell)(RenderBackend* backend, int row, int col, Cell cell);
+    void (*put_text)(RenderBackend* backend, int row, int col, const char* text); // The rest of the line is cleared
+    void (*present)(RenderBackend* backend); // The frame is done, show it
+    void (*release)(RenderBackend* backend); // Free the data
+};
+
+struct Renderer { // Remembers what is on the screen, so only the changes are drawn
+    RenderBackend* backend;
+    int rows; // Size of the view, the part of the board that is on the screen
+    int cols;
+    int top; // Board cell in the top left corner of the view
+    int left;
+    int board_rows; // Size of the board that the view was made for
+    int board_cols;
+    int level; // The level that the cached cells belong to, 0 if nothing is cached
+    Cell* level_cells; // What doesn't move in the view: start/end rows, roads, obstacles
+    Cell* frame; // The level cells with the cars, frog and stork on top of them
+    Cell* screen; // What is really on the screen
+    int* drawn; // Cells covered by the cars, frog and stork in the current frame
+    int num_drawn;
+    int* dirty; // Cells that could have changed since the last frame
+    int num_dirty;
+    bool all_dirty; // The whole view has to be compared, after the view moved
+    int capacity; // Size of the drawn array
+    char hud[HUD_LINES][HUD_WIDTH]; // Text lines that are on the screen
+};
+
+//********************
+//* RENDER FUNCTIONS *
+//********************
+
+void createColorPairs(); // render_curses.cpp, only with curses
+void initCursesBackend(RenderBackend* backend);
+void initAnsiBackend(RenderBackend* backend, int fd);
+void initNullBackend(RenderBackend* backend, int lines, int cols);
+void freeBackend(RenderBackend* backend);
+
+void initRenderer(Renderer* renderer, RenderBackend* backend);
+void freeRenderer(Renderer* renderer);
+void printEverything(Renderer* renderer, Board* board, Object* frog, Stork* stork, Timer* timer);
+void printText(Renderer* renderer, int row, int col, const char* text);
+void showFrame(Renderer* renderer);
+
+#endif
@@ -0,0 +1,63 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - drawing the game with curses
+    Version: 1.0
+*/
+
+#include <curses.h>
+#include "render.h"
+
+//*************************
+//* COLORS INITIALIZATION *
+//*************************
+
+void createColorPairs() {
+    start_color();
+    init_pair(END_COLOR, COLOR_GREEN, COLOR_GREEN);
+    init_pair(START_COLOR, COLOR_RED, COLOR_RED);
+    init_pair(FREE_COLOR, COLOR_YELLOW, COLOR_WHITE);
+    init_pair(OBSTACLE_COLOR, COLOR_BLACK, COLOR_WHITE);
+    init_pair(FROG_COLOR, COLOR_BLUE, COLOR_BLUE);
+    init_pair(FRIENDLY_COLOR, COLOR_WHITE, COLOR_GREEN);
+    init_pair(STORK_COLOR, COLOR_WHITE, COLOR_RED);
+}
+
+//******************
+//* CURSES BACKEND *
+//******************
+
+void cursesScreenSize(RenderBackend*, int* lines, int* cols) {
+    *lines = LINES;
+    *cols = COLS;
+}
+
+void cursesClear(RenderBackend*) {
+    erase();
+}
+
+void cursesPutCell(RenderBackend*, int row, int col, Cell cell) {
+    mvaddch(row, col, cell.symbol | COLOR_PAIR(cell.color));
+}
+
+void cursesPutText(RenderBackend*, int row, int col, const char* text) {
+    mvprintw(row, col, "%s", text);
+    clrtoeol();
+}
+
+void cursesPresent(RenderBackend*) {
+    refresh();
+}
+
+void cursesRelease(RenderBackend*) {
+}
+
+// Function to make a backend that draws on stdscr, curses has to be started (initscr) before
+void initCursesBackend(RenderBackend* backend) {
+    backend->data = NULL;
+    backend->screen_size = cursesScreenSize;
+    backend->clear = cursesClear;
+    backend->put_cell = cursesPutCell;
+    backend->put_text = cursesPutText;
+    backend->present = cursesPresent;
+    backend->release = cursesRelease;
+}
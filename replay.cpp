@@ -0,0 +1,232 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - recording and replaying games
+    Version: 1.0
+
+    The engine is deterministic: the same config (with the seed) and the same
+    inputs in the same steps always give the same game. So a recording is only
+    the config and the inputs, every input is the number of steps since the
+    previous one and the input itself packed into a varint, usually 1 or 2
+    bytes. The file is a header of REPLAY_HEADER_SIZE bytes (all numbers
+    little endian) followed by the events.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "replay.h"
+
+//**********************
+//* RECORDING AN INPUT *
+//**********************
+
+void initRecording(Recording* recording, const GameConfig* config) {
+    recording->config = *config;
+    recording->capacity = 4096; // a few minutes of playing, it grows if needed
+    recording->events = new unsigned char[recording->capacity];
+    recording->size = 0;
+    recording->last_tick = 0;
+    recording->end_tick = 0;
+    recording->status = GAME_RUNNING;
+    recording->points = 0;
+}
+
+// Function to add a byte to the events, making more room when needed
+void putByte(Recording* recording, unsigned char byte) {
+    if (recording->size == recording->capacity) {
+        unsigned char* events = new unsigned char[recording->capacity * 2];
+        memcpy(events, recording->events, recording->size);
+        delete[] recording->events;
+        recording->events = events;
+        recording->capacity *= 2;
+    }
+    recording->events[recording->size++] = byte;
+}
+
+// Function to write the input given to the step number tick, 7 bits per byte
+void recordInput(Recording* recording, long long tick, int input) {
+    unsigned long long value = (unsigned long long)(tick - recording->last_tick) << REPLAY_INPUT_BITS | input;
+    while (value >= 0x80) {
+        putByte(recording, (unsigned char)(value | 0x80));
+        value >>= 7;
+    }
+    putByte(recording, (unsigned char)value);
+    recording->last_tick = tick;
+}
+
+// Function to remember where and how the game ended
+void finishRecording(Recording* recording, const Game* game) {
+    recording->end_tick = game->tick;
+    recording->status = game->status;
+    recording->points = CalculatePoints(game->frog, game->timer);
+}
+
+// Function to forget the inputs given after the step number tick, the game was rewound to it
+void truncateRecording(Recording* recording, long long tick) {
+    size_t position = 0;
+    long long event_tick = 0;
+    long long last_tick = 0;
+    while (position < recording->size) {
+        size_t start = position;
+        unsigned long long value = 0;
+        int shift = 0;
+        unsigned char byte;
+        do {
+            byte = recording->events[position++];
+            value |= (unsigned long long)(byte & 0x7F) << shift;
+            shift += 7;
+        } while ((byte & 0x80) && position < recording->size);
+        event_tick += (long long)(value >> REPLAY_INPUT_BITS);
+        if (event_tick > tick) {
+            recording->size = start;
+            break;
+        }
+        last_tick = event_tick;
+    }
+    recording->last_tick = last_tick;
+}
+
+void freeRecording(Recording* recording) {
+    delete[] recording->events;
+    recording->events = NULL;
+    recording->size = 0;
+    recording->capacity = 0;
+}
+
+//*******************
+//* RECORDING FILES *
+//*******************
+
+void writeNumber(unsigned char* out, unsigned long long value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        out[i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+unsigned long long readNumber(const unsigned char* in, int bytes) {
+    unsigned long long value = 0;
+    for (int i = 0; i < bytes; i++) {
+        value |= (unsigned long long)in[i] << (8 * i);
+    }
+    return value;
+}
+
+bool saveRecording(const Recording* recording, const char* filename) {
+    unsigned char header[REPLAY_HEADER_SIZE];
+    memcpy(header, REPLAY_MAGIC, 8);
+    writeNumber(header + 8, recording->config.frog_speed, 4);
+    writeNumber(header + 12, recording->config.car_min_speed, 4);
+    writeNumber(header + 16, recording->config.car_max_speed, 4);
+    writeNumber(header + 20, recording->config.rows, 4);
+    writeNumber(header + 24, recording->config.cols, 4);
+    writeNumber(header + 28, recording->config.tick_rate, 4);
+    writeNumber(header + 32, recording->config.seed, 8);
+    writeNumber(header + 40, recording->end_tick, 8);
+    writeNumber(header + 48, recording->status, 4);
+    writeNumber(header + 52, recording->points, 4);
+    writeNumber(header + 56, recording->config.cars_per_road, 4);
+    writeNumber(header + 60, 0, 4); // unused
+    FILE* file = fopen(filename, "wb");
+    if (file == NULL) {
+        printf("Error: can't write %s!\n", filename);
+        return false;
+    }
+    bool ok = fwrite(header, 1, REPLAY_HEADER_SIZE, file) == REPLAY_HEADER_SIZE;
+    ok = ok && fwrite(recording->events, 1, recording->size, file) == recording->size;
+    ok = fclose(file) == 0 && ok;
+    return ok;
+}
+
+bool loadRecording(Recording* recording, const char* filename) {
+    FILE* file = fopen(filename, "rb");
+    if (file == NULL) {
+        printf("Error: %s file not found!\n", filename);
+        return false;
+    }
+    unsigned char header[REPLAY_HEADER_SIZE];
+    if (fread(header, 1, REPLAY_HEADER_SIZE, file) != REPLAY_HEADER_SIZE || memcmp(header, REPLAY_MAGIC, 8) != 0) {
+        printf("Error: %s is not a recording!\n", filename);
+        fclose(file);
+        return false;
+    }
+    GameConfig config;
+    config.frog_speed = (int)readNumber(header + 8, 4);
+    config.car_min_speed = (int)readNumber(header + 12, 4);
+    config.car_max_speed = (int)readNumber(header + 16, 4);
+    config.rows = (int)readNumber(header + 20, 4);
+    config.cols = (int)readNumber(header + 24, 4);
+    config.tick_rate = (int)readNumber(header + 28, 4);
+    config.seed = readNumber(header + 32, 8);
+    config.cars_per_road = (int)readNumber(header + 56, 4);
+    config.background_levels = false;
+    initRecording(recording, &config);
+    recording->end_tick = (long long)readNumber(header + 40, 8);
+    recording->status = (int)readNumber(header + 48, 4);
+    recording->points = (int)readNumber(header + 52, 4);
+    int byte;
+    while ((byte = fgetc(file)) != EOF) {
+        putByte(recording, (unsigned char)byte);
+    }
+    fclose(file);
+    return true;
+}
+
+//********************
+//* PLAYING IT AGAIN *
+//********************
+
+// Function to read the next input, the step of the input is counted from the previous one
+void readEvent(Replay* replay) {
+    const Recording* recording = replay->recording;
+    unsigned long long value = 0;
+    int shift = 0;
+    while (replay->position < recording->size) {
+        unsigned char byte = recording->events[replay->position++];
+        value |= (unsigned long long)(byte & 0x7F) << shift;
+        shift += 7;
+        if (!(byte & 0x80)) {
+            replay->next_tick += (long long)(value >> REPLAY_INPUT_BITS);
+            replay->next_input = int(value & ((1 << REPLAY_INPUT_BITS) - 1));
+            return;
+        }
+    }
+    replay->next_tick = -1; // no more inputs
+    replay->next_input = INPUT_NONE;
+}
+
+// Function to start the recorded game from the beginning
+void startReplay(Replay* replay, const Recording* recording) {
+    replay->recording = recording;
+    initGame(&replay->game, &recording->config);
+    replay->position = 0;
+    replay->next_tick = 0;
+    readEvent(replay);
+}
+
+bool replayFinished(const Replay* replay) {
+    return replay->game.status != GAME_RUNNING || replay->game.tick >= replay->recording->end_tick;
+}
+
+// Function to simulate one step with the input that was given in it
+int replayStep(Replay* replay) {
+    int input = INPUT_NONE;
+    if (replay->next_tick == replay->game.tick + 1) {
+        input = replay->next_input;
+        readEvent(replay);
+    }
+    return step(&replay->game, input);
+}
+
+// Function to go to the given step, going back means simulating the game again from the start
+void seekReplay(Replay* replay, long long tick) {
+    if (tick < replay->game.tick) {
+        freeGame(&replay->game);
+        startReplay(replay, replay->recording);
+    }
+    while (replay->game.tick < tick && !replayFinished(replay)) {
+        replayStep(replay);
+    }
+}
+
+void freeReplay(Replay* replay) {
+    freeGame(&replay->game);
+}
@@ -0,0 +1,62 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - recording and replaying games
+    Version: 1.0
+*/
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stddef.h>
+#include "engine.h"
+
+//**********************
+//* DEFINING CONSTANTS *
+//**********************
+
+#define REPLAY_MAGIC "FROGREC4" // FIRST 8 BYTES OF EVERY RECORDING FILE
+#define REPLAY_HEADER_SIZE 64
+#define REPLAY_INPUT_BITS 3 // INPUTS FIT INTO THE LOW BITS OF AN EVENT
+
+//***********************
+//* DEFINING STRUCTURES *
+//***********************
+
+struct Recording { // Everything that is needed to play a game again: the config with the seed and the inputs
+    GameConfig config;
+    unsigned char* events; // For every input: (steps since the previous input << 3 | input) as a varint
+    size_t size;
+    size_t capacity;
+    long long last_tick; // Step of the last recorded input
+    long long end_tick; // Step in which the recording was stopped
+    int status; // How the game ended and the points it got, to check them when replaying
+    int points;
+};
+
+struct Replay { // A recorded game that is being played again
+    const Recording* recording;
+    Game game;
+    size_t position; // Next event to read
+    long long next_tick; // Step of the next input, -1 if there are no more inputs
+    int next_input;
+};
+
+//********************
+//* REPLAY FUNCTIONS *
+//********************
+
+void initRecording(Recording* recording, const GameConfig* config);
+void recordInput(Recording* recording, long long tick, int input);
+void finishRecording(Recording* recording, const Game* game);
+void truncateRecording(Recording* recording, long long tick);
+bool saveRecording(const Recording* recording, const char* filename);
+bool loadRecording(Recording* recording, const char* filename);
+void freeRecording(Recording* recording);
+
+void startReplay(Replay* replay, const Recording* recording);
+int replayStep(Replay* replay);
+void seekReplay(Replay* replay, long long tick);
+bool replayFinished(const Replay* replay);
+void freeReplay(Replay* replay);
+
+#endif
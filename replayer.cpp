@@ -0,0 +1,97 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - checking recorded games
+    Version: 1.0
+
+    Plays a recorded game again as fast as possible and checks that it ends
+    the same way and with the same points as when it was recorded. Usage:
+        frog-replay FILE [--seek SECONDS]
+    With --seek the state of the game at the given time is shown as well.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "engine.h"
+#include "replay.h"
+
+//*****************
+//* SHOWING STATE *
+//*****************
+
+const char* statusName(int status) {
+    if (status == GAME_OVER) {
+        return "game over";
+    }
+    if (status == GAME_WON) {
+        return "won";
+    }
+    return "stopped";
+}
+
+void printState(const Game* game) {
+    printf("time %.2f s (step %lld): level %d, frog at %d,%d, lanes passed %d, stork at %d,%d\n",
+        game->now, game->tick, game->frog->level, game->frog->x, game->frog->y,
+        game->frog->lanes_passed, game->stork->x, game->stork->y);
+}
+
+//*****************
+//* MAIN FUNCTION *
+//*****************
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printf("Usage: frog-replay FILE [--seek SECONDS]\n");
+        return 1;
+    }
+    double seek_time = -1;
+    for (int i = 2; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--seek") == 0) {
+            seek_time = atof(argv[i + 1]);
+        }
+        else {
+            printf("Unknown option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    Recording recording;
+    if (!loadRecording(&recording, argv[1])) {
+        return 1;
+    }
+    const GameConfig* config = &recording.config;
+    printf("board: %dx%d, %d cars per road, frog speed %d, car speed %d-%d, %d steps per second, seed %llu\n",
+        config->rows, config->cols, config->cars_per_road, config->frog_speed, config->car_min_speed,
+        config->car_max_speed, config->tick_rate, recording.config.seed);
+    printf("recording: %zu bytes of inputs, %lld steps\n", recording.size, recording.end_tick);
+
+    Replay replay;
+    startReplay(&replay, &recording);
+    if (seek_time >= 0) {
+        seekReplay(&replay, (long long)(seek_time * config->tick_rate + 0.5));
+        printState(&replay.game);
+        seekReplay(&replay, 0); // back to the start, to check the whole game
+    }
+
+    clock_t start_time = clock();
+    while (!replayFinished(&replay)) {
+        replayStep(&replay);
+    }
+    double cpu_time = double(clock() - start_time) / CLOCKS_PER_SEC;
+
+    const Game* game = &replay.game;
+    int points = CalculatePoints(game->frog, game->timer);
+    printState(game);
+    printf("result: %s, %d points (recorded: %s, %d points)\n", statusName(game->status), points,
+        statusName(recording.status), recording.points);
+    if (cpu_time > 0) {
+        printf("replayed at %.0f steps per second\n", game->tick / cpu_time);
+    }
+    bool same = game->status == recording.status && points == recording.points && game->tick == recording.end_tick;
+    printf("%s\n", same ? "OK: the replay matches the recording" : "MISMATCH: the replay doesn't match the recording");
+
+    freeReplay(&replay);
+    freeRecording(&recording);
+    return same ? 0 : 2;
+}
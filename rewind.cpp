@@ -0,0 +1,364 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - rewinding the game
+    Version: 1.0
+
+    After every step the state of the game is saved, so the game can go back
+    step by step. The state is everything that changes while a level is
+    played: the cars with their timing wheel, the roads, the frog, the stork,
+    the timer, the friendly cars and the random stream. It is gathered into
+    one image of 64-bit words. Every REWIND_KEYFRAME_INTERVAL snapshots the
+    whole image is kept (a keyframe), the others only keep the runs of the
+    words that differ from the snapshot before them, so going back is a copy
+    of the keyframe and at most REWIND_KEYFRAME_INTERVAL - 1 small deltas. The
+    snapshots are in a ring of fixed size, when it is full the oldest keyframe
+    is dropped together with its deltas. The bits of the cells taken by the
+    cars and the stork and the distance field of the stork aren't saved, they
+    follow from the rest and are made again after the rewind. A new level
+    starts the buffer again, the game only goes back within the level.
+*/
+
+#include <string.h>
+#include "replay.h"
+#include "rewind.h"
+
+//***********************
+//* DEFINING STRUCTURES *
+//***********************
+
+struct GameState { // The parts of the state that aren't in the arena of the board, the first words of the image
+    long long tick;
+    double now;
+    int status;
+    Object frog;
+    Stork stork;
+    Timer timer;
+    long long wheel_tick;
+    int spaces_count;
+    bool friendly_on;
+    RandomStream random;
+};
+
+#define STATE_WORDS ((sizeof(GameState) + 7) / 8)
+
+//********************
+//* THE STATE IMAGES *
+//********************
+
+void forgetSnapshots(RewindBuffer* rewind) {
+    rewind->write = 0;
+    rewind->first = 0;
+    rewind->count = 0;
+    rewind->since_keyframe = 0;
+}
+
+void addRegion(RewindBuffer* rewind, void* data, size_t bytes) {
+    rewind->regions[rewind->num_regions].data = data;
+    rewind->regions[rewind->num_regions].bytes = bytes;
+    rewind->num_regions++;
+}
+
+// Function to find the parts of the state of the new level and start the buffer again
+void startLevelSnapshots(RewindBuffer* rewind, const Game* game) {
+    Board* board = game->board;
+    CarStore* cars = &board->cars;
+    size_t car_ints = (size_t)cars->count * sizeof(int);
+    rewind->num_regions = 0;
+    addRegion(rewind, board->roads, board->num_roads * sizeof(Road));
+    addRegion(rewind, cars->x, car_ints);
+    addRegion(rewind, cars->y, car_ints);
+    addRegion(rewind, cars->direction, car_ints);
+    addRegion(rewind, cars->speed, car_ints);
+    addRegion(rewind, cars->move_interval, car_ints);
+    addRegion(rewind, cars->next_move, car_ints);
+    addRegion(rewind, cars->stopping, car_ints);
+    addRegion(rewind, cars->active, car_ints);
+    addRegion(rewind, cars->symbol, cars->count);
+    addRegion(rewind, board->wheel.head, WHEEL_SLOTS * sizeof(int));
+    size_t entry_ints = (size_t)(cars->count + board->num_roads) * sizeof(int); // the cars and the new cars of the roads
+    addRegion(rewind, board->wheel.next, entry_ints);
+    addRegion(rewind, board->wheel.prev, entry_ints);
+    addRegion(rewind, board->wheel.slot, entry_ints);
+
+    rewind->image_words = STATE_WORDS;
+    for (int i = 0; i < rewind->num_regions; i++) {
+        rewind->image_words += (rewind->regions[i].bytes + 7) / 8;
+    }
+    if (rewind->image_words > rewind->image_capacity) { // the images only grow, a level never makes them smaller
+        delete[] rewind->image;
+        delete[] rewind->previous;
+        delete[] rewind->delta;
+        rewind->image_capacity = rewind->image_words;
+        rewind->image = new uint64_t[rewind->image_capacity];
+        rewind->previous = new uint64_t[rewind->image_capacity];
+        rewind->delta = new uint64_t[rewind->image_capacity];
+    }
+    memset(rewind->image, 0, rewind->image_words * sizeof(uint64_t)); // the padding after a region stays 0
+    memset(rewind->previous, 0, rewind->image_words * sizeof(uint64_t));
+    rewind->board = game->board;
+    rewind->level = game->frog->level;
+    forgetSnapshots(rewind);
+}
+
+// Function to copy the state of the game into the image
+void gatherState(RewindBuffer* rewind, const Game* game) {
+    GameState state;
+    memset(&state, 0, sizeof(state)); // so the padding is the same in every image
+    state.tick = game->tick;
+    state.now = game->now;
+    state.status = game->status;
+    state.frog = *game->frog;
+    state.stork = *game->stork;
+    state.timer = *game->timer;
+    state.wheel_tick = game->board->wheel.tick;
+    state.spaces_count = game->board->spaces_count;
+    state.friendly_on = game->board->friendly_on;
+    state.random = game->board->random;
+    memcpy(rewind->image, &state, sizeof(state));
+    uint64_t* out = rewind->image + STATE_WORDS;
+    for (int i = 0; i < rewind->num_regions; i++) {
+        memcpy(out, rewind->regions[i].data, rewind->regions[i].bytes);
+        out += (rewind->regions[i].bytes + 7) / 8;
+    }
+}
+
+// Function to put the state from the image back into the game
+void scatterState(const RewindBuffer* rewind, Game* game) {
+    Board* board = game->board;
+    clearBit(storkBits(&board->occupancy, game->stork->x), game->stork->y);
+    GameState state;
+    memcpy(&state, rewind->image, sizeof(state));
+    game->tick = state.tick;
+    game->now = state.now;
+    game->status = state.status;
+    *game->frog = state.frog;
+    *game->stork = state.stork;
+    *game->timer = state.timer;
+    board->wheel.tick = state.wheel_tick;
+    board->spaces_count = state.spaces_count;
+    board->friendly_on = state.friendly_on;
+    board->random = state.random;
+    const uint64_t* in = rewind->image + STATE_WORDS;
+    for (int i = 0; i < rewind->num_regions; i++) {
+        memcpy(rewind->regions[i].data, in, rewind->regions[i].bytes);
+        in += (rewind->regions[i].bytes + 7) / 8;
+    }
+
+    // the bits of the cells only follow from the cars and the stork, so they aren't saved
+    Occupancy* occupancy = &board->occupancy;
+    memset(occupancy->cars, 0, (size_t)board->num_roads * occupancy->words * sizeof(uint64_t));
+    for (int i = 0; i < board->num_roads; i++) {
+        for (int j = 0; j < board->roads[i].count; j++) {
+            setBit(carBits(occupancy, i), board->cars.y[laneSlot(board, i, j)]);
+        }
+    }
+    setBit(storkBits(occupancy, game->stork->x), game->stork->y);
+    board->stork_field.frog_x = -1; // the field is made again for the frog where it is now
+}
+
+//**********
+//* DELTAS *
+//**********
+
+// Function to write the runs of the words that differ from the snapshot before: a word with the start (high 32 bits)
+// and the length of the run, then the words of the run. One word that is the same between two runs is taken
+// into the run, it costs as much as a new start. Returns the length, at least room if it doesn't fit
+size_t encodeDelta(const uint64_t* image, const uint64_t* previous, size_t words, uint64_t* out, size_t room) {
+    size_t length = 0;
+    size_t i = 0;
+    while (i < words) {
+        if (image[i] == previous[i]) {
+            i++;
+            continue;
+        }
+        size_t end = i + 1;
+        while (end < words && (image[end] != previous[end] || (end + 1 < words && image[end + 1] != previous[end + 1]))) {
+            end++;
+        }
+        if (length + 1 + (end - i) >= room) {
+            return room;
+        }
+        out[length++] = (uint64_t)i << 32 | (end - i);
+        memcpy(out + length, image + i, (end - i) * sizeof(uint64_t));
+        length += end - i;
+        i = end;
+    }
+    return length;
+}
+
+void applyDelta(uint64_t* image, const uint64_t* delta, size_t length) {
+    size_t i = 0;
+    while (i < length) {
+        size_t start = (size_t)(delta[i] >> 32);
+        size_t count = (size_t)(delta[i] & 0xFFFFFFFFULL);
+        memcpy(image + start, delta + i + 1, count * sizeof(uint64_t));
+        i += 1 + count;
+    }
+}
+
+//*******************
+//* THE RING BUFFER *
+//*******************
+
+// Function to drop the oldest keyframe and the deltas that need it
+void dropOldest(RewindBuffer* rewind) {
+    do {
+        rewind->first = rewind->first + 1 == rewind->capacity ? 0 : rewind->first + 1;
+        rewind->count--;
+    } while (rewind->count > 0 && !rewind->snapshots[rewind->first].keyframe);
+}
+
+// Function to make room for a snapshot of the given number of words, dropping the oldest snapshots that are
+// in the way. Returns the offset of the room, -1 if the snapshot is bigger than the whole buffer
+long long reserveSnapshot(RewindBuffer* rewind, size_t words) {
+    if (words > rewind->size) {
+        return -1;
+    }
+    size_t offset = rewind->write;
+    bool wrapped = offset + words > rewind->size;
+    if (wrapped) {
+        offset = 0;
+    }
+    while (rewind->count > 0) {
+        const Snapshot* oldest = &rewind->snapshots[rewind->first];
+        bool overlaps = oldest->offset < offset + words && offset < oldest->offset + oldest->length;
+        bool skipped = wrapped && oldest->offset >= rewind->write; // the end of the ring isn't used in this round
+        if (!overlaps && !skipped && rewind->count < rewind->capacity) {
+            break;
+        }
+        dropOldest(rewind);
+    }
+    return (long long)offset;
+}
+
+//********************
+//* REWIND FUNCTIONS *
+//********************
+
+void initRewind(RewindBuffer* rewind, size_t memory, int max_snapshots) {
+    rewind->size = memory / sizeof(uint64_t);
+    rewind->data = new uint64_t[rewind->size];
+    memset(rewind->data, 0, rewind->size * sizeof(uint64_t)); // the pages are touched now and not in the first minutes of the game
+    rewind->capacity = max_snapshots > 0 ? max_snapshots : 1;
+    rewind->snapshots = new Snapshot[rewind->capacity];
+    rewind->board = NULL;
+    rewind->level = 0;
+    rewind->num_regions = 0;
+    rewind->image_words = 0;
+    rewind->image_capacity = 0;
+    rewind->image = NULL;
+    rewind->previous = NULL;
+    rewind->delta = NULL;
+    clearRewind(rewind);
+}
+
+// Function to forget every snapshot, a new game has to start with it
+void clearRewind(RewindBuffer* rewind) {
+    rewind->board = NULL; // the board of the new game may be where the old one was
+    forgetSnapshots(rewind);
+}
+
+// Function to save the state after a step, it has to be called after every step that can be gone back to
+void saveSnapshot(RewindBuffer* rewind, const Game* game) {
+    if (game->board != rewind->board || game->frog->level != rewind->level) {
+        startLevelSnapshots(rewind, game);
+    }
+    gatherState(rewind, game);
+    size_t words = rewind->image_words;
+    bool keyframe = rewind->count == 0 || rewind->since_keyframe + 1 >= REWIND_KEYFRAME_INTERVAL;
+    size_t length = words;
+    long long offset = -1;
+    if (!keyframe) {
+        length = encodeDelta(rewind->image, rewind->previous, words, rewind->delta, words);
+        keyframe = length >= words; // nearly everything changed
+    }
+    if (!keyframe) {
+        offset = reserveSnapshot(rewind, length);
+        keyframe = rewind->count == 0; // the room was made by dropping the snapshots that the delta needs
+    }
+    if (keyframe) {
+        length = words;
+        offset = reserveSnapshot(rewind, length);
+        if (offset < 0) {
+            return;
+        }
+    }
+    memcpy(rewind->data + offset, keyframe ? rewind->image : rewind->delta, length * sizeof(uint64_t));
+    int index = rewind->first + rewind->count;
+    Snapshot* snapshot = &rewind->snapshots[index >= rewind->capacity ? index - rewind->capacity : index];
+    snapshot->tick = game->tick;
+    snapshot->offset = (size_t)offset;
+    snapshot->length = length;
+    snapshot->keyframe = keyframe;
+    rewind->count++;
+    rewind->write = (size_t)offset + length;
+    rewind->since_keyframe = keyframe ? 0 : rewind->since_keyframe + 1;
+    uint64_t* image = rewind->image; // the next delta is made against this image
+    rewind->image = rewind->previous;
+    rewind->previous = image;
+}
+
+// Function to take the game back by the given number of steps (or to the oldest snapshot), the snapshots after
+// it and the recorded inputs after it are forgotten. Returns the number of steps it went back
+long long rewindGame(RewindBuffer* rewind, Game* game, long long steps) {
+    if (rewind->count == 0 || game->board != rewind->board || game->frog->level != rewind->level) {
+        return 0;
+    }
+    long long target = rewind->count - 1 - steps;
+    if (target < 0) {
+        target = 0;
+    }
+    int index = (int)((rewind->first + target) % rewind->capacity);
+    int key = index;
+    while (!rewind->snapshots[key].keyframe) {
+        key = key == 0 ? rewind->capacity - 1 : key - 1;
+    }
+    const Snapshot* snapshot = &rewind->snapshots[index];
+    memcpy(rewind->image, rewind->data + rewind->snapshots[key].offset, rewind->image_words * sizeof(uint64_t));
+    for (int i = key; i != index;) {
+        i = i + 1 == rewind->capacity ? 0 : i + 1;
+        applyDelta(rewind->image, rewind->data + rewind->snapshots[i].offset, rewind->snapshots[i].length);
+    }
+    memcpy(rewind->previous, rewind->image, rewind->image_words * sizeof(uint64_t));
+    rewind->since_keyframe = index >= key ? index - key : index + rewind->capacity - key;
+    rewind->count = (int)target + 1;
+    rewind->write = snapshot->offset + snapshot->length;
+
+    long long back = game->tick - snapshot->tick;
+    scatterState(rewind, game);
+    if (game->recording != NULL) {
+        truncateRecording(game->recording, game->tick);
+    }
+    return back;
+}
+
+// Number of steps that the game can go back
+long long rewindSteps(const RewindBuffer* rewind) {
+    if (rewind->count == 0) {
+        return 0;
+    }
+    int last = (rewind->first + rewind->count - 1) % rewind->capacity;
+    return rewind->snapshots[last].tick - rewind->snapshots[rewind->first].tick;
+}
+
+// Bytes taken by the snapshots in the ring
+size_t rewindMemory(const RewindBuffer* rewind) {
+    size_t words = 0;
+    for (int i = 0, index = rewind->first; i < rewind->count; i++, index = index + 1 == rewind->capacity ? 0 : index + 1) {
+        words += rewind->snapshots[index].length;
+    }
+    return words * sizeof(uint64_t);
+}
+
+void freeRewind(RewindBuffer* rewind) {
+    delete[] rewind->data;
+    delete[] rewind->snapshots;
+    delete[] rewind->image;
+    delete[] rewind->previous;
+    delete[] rewind->delta;
+    rewind->data = NULL;
+    rewind->snapshots = NULL;
+    rewind->image = NULL;
+    rewind->previous = NULL;
+    rewind->delta = NULL;
+}
@@ -0,0 +1,74 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - rewinding the game
+    Version: 1.0
+*/
+
+#ifndef REWIND_H
+#define REWIND_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "engine.h"
+
+//**********************
+//* DEFINING CONSTANTS *
+//**********************
+
+#define REWIND_MEMORY (16 << 20) // BYTES OF SNAPSHOTS, A MINUTE OF A GAME ON A TERMINAL TAKES A FEW MB
+#define REWIND_MAX_SNAPSHOTS 65536 // ABOUT 11 MINUTES AT 100 STEPS PER SECOND
+#define REWIND_KEYFRAME_INTERVAL 64 // EVERY 64TH SNAPSHOT IS A WHOLE COPY OF THE STATE, THE OTHERS ONLY KEEP WHAT CHANGED IN THEIR STEP
+#define REWIND_MAX_REGIONS 24
+
+//***********************
+//* DEFINING STRUCTURES *
+//***********************
+
+struct StateRegion { // A part of the memory of the game that changes while a level is played
+    void* data;
+    size_t bytes;
+};
+
+struct Snapshot { // The state after one step
+    long long tick;
+    size_t offset; // Where it is in the data of the buffer, in words
+    size_t length; // Words
+    bool keyframe; // The whole state, otherwise runs of the words that differ from the snapshot before it
+};
+
+struct RewindBuffer { // The last snapshots of the level, the oldest ones are dropped when there is no room
+    uint64_t* data; // Ring of the snapshots, a snapshot that doesn't fit at the end starts again at 0
+    size_t size; // Words
+    size_t write; // Where the next snapshot goes
+    Snapshot* snapshots; // Ring of the snapshots in the order they were taken
+    int capacity;
+    int first; // The oldest snapshot
+    int count;
+    const Board* board; // The level that the snapshots are of, a new level starts again
+    int level;
+    StateRegion regions[REWIND_MAX_REGIONS]; // The parts of the state, gathered into one image one after another
+    int num_regions;
+    size_t image_words; // Words of one image of the state
+    size_t image_capacity;
+    uint64_t* image; // The state now
+    uint64_t* previous; // The state in the last snapshot
+    uint64_t* delta; // Room for a delta before it goes into the ring
+    int since_keyframe; // Snapshots taken after the last keyframe
+};
+
+//********************
+//* REWIND FUNCTIONS *
+//********************
+
+void initRewind(RewindBuffer* rewind, size_t memory, int max_snapshots);
+void clearRewind(RewindBuffer* rewind);
+void saveSnapshot(RewindBuffer* rewind, const Game* game);
+long long rewindGame(RewindBuffer* rewind, Game* game, long long steps);
+long long rewindSteps(const RewindBuffer* rewind);
+size_t rewindMemory(const RewindBuffer* rewind);
+void freeRewind(RewindBuffer* rewind);
+
+size_t encodeDelta(const uint64_t* image, const uint64_t* previous, size_t words, uint64_t* out, size_t room);
+void applyDelta(uint64_t* image, const uint64_t* delta, size_t length);
+
+#endif
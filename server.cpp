@@ -0,0 +1,852 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - game server
+    Version: 1.0
+
+    Plays many games at once, every client that connects gets its own game and
+    telnet is enough to play it. The games are split between the shards, a
+    shard is a thread with its own epoll and its own games, so a game is only
+    ever touched by one thread and nothing has to be locked. The main thread
+    only accepts the clients and hands them to the shards in turn through a
+    pipe. A shard steps all of its games at the tick rate and a few times per
+    second sends every client a frame of text, a view of the board around the
+    frog. Usage:
+        frog-server [--port P] [--unix PATH] [--threads N] [--rows R] [--cols C] [--seed S]
+    The keys are w/a/s/d or the arrows, space for the friendly cars, r to play
+    again after the end of a game and q to leave.
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "engine.h"
+
+//**********************
+//* DEFINING CONSTANTS *
+//**********************
+
+#define DEFAULT_PORT 4000
+#define DEFAULT_ROWS 26 // THE SAME BOARD AS IN frog-headless
+#define DEFAULT_COLS 50
+#define VIEW_ROWS 20 // THE PART OF THE BOARD SENT TO A CLIENT, IT FOLLOWS THE FROG
+#define VIEW_COLS 60
+#define FRAME_RATE 10 // FRAMES PER SECOND SENT TO EVERY CLIENT
+#define FRAME_SIZE (VIEW_ROWS * (VIEW_COLS + 8) + 1024) // THE MOST TEXT IN ONE FRAME
+#define MAX_OUTPUT 8192 // A CLIENT WITH THIS MUCH UNREAD TEXT MISSES FRAMES UNTIL IT CATCHES UP
+#define MAX_CATCH_UP 25 // THE MOST STEPS SIMULATED AT ONCE WHEN A SHARD FALLS BEHIND, THE REST ARE SKIPPED
+#define MAX_EVENTS 256
+#define STATS_INTERVAL 5 // SECONDS BETWEEN THE LINES OF STATISTICS
+
+#define PARSE_TEXT 0 // WHAT THE LAST BYTES FROM A CLIENT WERE
+#define PARSE_ESCAPE 1 // ESC, AN ARROW MAY FOLLOW
+#define PARSE_ARROW 2 // ESC [ OR ESC O
+#define PARSE_COMMAND 3 // TELNET IAC
+#define PARSE_OPTION 4 // TELNET WILL/WONT/DO/DONT
+#define PARSE_SUBOPTION 5 // TELNET SB ... IAC SE
+#define PARSE_SUBOPTION_END 6
+
+#define TELNET_IAC 255
+#define TELNET_SB 250
+#define TELNET_SE 240
+
+const unsigned char TELNET_CHARACTER_MODE[] = {255, 251, 1, 255, 251, 3}; // IAC WILL ECHO, IAC WILL SUPPRESS-GO-AHEAD
+const char HIDE_CURSOR[] = "\x1b[?25l\x1b[2J";
+const char SHOW_CURSOR[] = "\x1b[?25h\r\n";
+
+//***********************
+//* DEFINING STRUCTURES *
+//***********************
+
+struct Session { // One client and its game, only its shard's thread touches it
+    int fd;
+    int index; // Place in the sessions of the shard
+    Game game;
+    bool playing; // false after the end of the game, until the client asks for a new one
+    bool writing; // true while epoll waits for the socket to take the rest of the output
+    bool closed; // The client is gone, the session is freed after the events that epoll returned with it
+    int input; // Input for the next step, the last key wins
+    int parse_state;
+    int output_sent; // output[output_sent ... output_used - 1] wasn't sent yet
+    int output_used;
+    char output[MAX_OUTPUT];
+};
+
+struct Shard { // A thread with its own epoll and its own sessions
+    int index;
+    int epoll_fd;
+    int timer_fd; // Fires at the tick rate
+    int wake_fds[2]; // The main thread writes the fds of the new clients to wake_fds[1]
+    GameConfig config;
+    unsigned long long next_seed; // The shards take turns, so no two games get the same seed
+    int seed_step;
+    long long ticks;
+    int frame_interval; // Steps between two frames
+    std::vector<Session*> sessions;
+    std::vector<Session*> closed; // Freed at the end of the events of one epoll_wait
+    char frame[FRAME_SIZE];
+    std::thread thread;
+    std::atomic<int> session_count; // Read by the main thread for the statistics
+    std::atomic<long long> steps;
+    std::atomic<long long> skipped_steps;
+    std::atomic<long long> frames;
+    std::atomic<long long> bytes_sent;
+};
+
+std::atomic<bool> stopping(false);
+
+void onSignal(int) {
+    stopping = true;
+}
+
+//****************************
+//* SOCKET RELATED FUNCTIONS *
+//****************************
+
+bool makeNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+// Function to open a listening TCP socket on every address, returns -1 on error
+int listenTcp(int port) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    if (bind(fd, (sockaddr*)&address, sizeof(address)) != 0 || listen(fd, SOMAXCONN) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Function to open a listening Unix socket, an old socket file with the same name is removed
+int listenUnix(const char* path) {
+    sockaddr_un address;
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        return -1;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+    unlink(path);
+    if (bind(fd, (sockaddr*)&address, sizeof(address)) != 0 || listen(fd, SOMAXCONN) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Function to allow as many open files as the system lets, every client is one
+void raiseFileLimit() {
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+//*************************
+//* FRAME OF TEXT OF GAME *
+//*************************
+
+// Function to get the symbol of the level (without the moving things) in the given place of the board
+char levelSymbol(const Board* board, int x, int y) {
+    if (x == 0 || x == board->rows - 1) {
+        return '=';
+    }
+    if (board->occupancy.road_of_row[x] >= 0) {
+        return '-';
+    }
+    if (isObstacle(board, x, y)) {
+        return 'X';
+    }
+    return board->grid[x][y];
+}
+
+// Function to put a moving thing on the view, the coordinates are the ones of the board
+void drawSymbol(char* view, int top, int left, int rows, int cols, int x, int y, char symbol) {
+    x -= top;
+    y -= left;
+    if (x >= 0 && x < rows && y >= 0 && y < cols) {
+        view[x * cols + y] = symbol;
+    }
+}
+
+// Function to write a frame of the game to the text, the view is centered on the frog. Returns its length
+int buildFrame(const Game* game, bool playing, char* text) {
+    const Board* board = game->board;
+    const Object* frog = game->frog;
+    int rows = board->rows < VIEW_ROWS ? board->rows : VIEW_ROWS;
+    int cols = board->cols - 1 < VIEW_COLS ? board->cols - 1 : VIEW_COLS;
+    int top = frog->x - rows / 2;
+    int left = frog->y - cols / 2;
+    // the view never goes past the edges of the board
+    if (top > board->rows - rows) {
+        top = board->rows - rows;
+    }
+    if (left > board->cols - 1 - cols) {
+        left = board->cols - 1 - cols;
+    }
+    if (top < 0) {
+        top = 0;
+    }
+    if (left < 0) {
+        left = 0;
+    }
+
+    char view[VIEW_ROWS * VIEW_COLS];
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) {
+            view[i * cols + j] = levelSymbol(board, top + i, left + j);
+        }
+    }
+    for (int x = top; x < top + rows; x++) {
+        int road = board->occupancy.road_of_row[x];
+        if (road < 0) {
+            continue;
+        }
+        for (int j = 0; j < board->roads[road].count; j++) {
+            int i = laneSlot(board, road, j);
+            drawSymbol(view, top, left, rows, cols, board->cars.x[i], board->cars.y[i], board->cars.symbol[i]);
+        }
+    }
+    drawSymbol(view, top, left, rows, cols, frog->x, frog->y, frog->symbol);
+    drawSymbol(view, top, left, rows, cols, game->stork->x, game->stork->y, game->stork->symbol);
+
+    int length = 0;
+    memcpy(text, "\x1b[H", 3); // to the top left corner, the last frame is written over
+    length += 3;
+    for (int i = 0; i < rows; i++) {
+        memcpy(text + length, &view[i * cols], cols);
+        length += cols;
+        memcpy(text + length, "\x1b[K\r\n", 5);
+        length += 5;
+    }
+    length += snprintf(text + length, FRAME_SIZE - length, "Level: %d  Time: %.2f s  Lanes passed: %d  Friendly cars: %s\x1b[K\r\n",
+                       frog->level, game->timer->current_time, frog->lanes_passed, board->friendly_on ? "on" : "off");
+    if (playing) {
+        length += snprintf(text + length, FRAME_SIZE - length, "w/a/s/d or arrows to move, space for the friendly cars, q to leave\x1b[K\r\n");
+    }
+    else {
+        length += snprintf(text + length, FRAME_SIZE - length, "%s %d points. Press r to play again or q to leave\x1b[K\r\n",
+                           game->status == GAME_WON ? "You won!" : "Game over!", CalculatePoints(frog, game->timer));
+    }
+    memcpy(text + length, "\x1b[J", 3); // nothing of a bigger old frame is left below
+    return length + 3;
+}
+
+//*****************************
+//* SESSION RELATED FUNCTIONS *
+//*****************************
+
+// Function to start the next game of the session in the memory of its last game, so playing again allocates nothing
+void startGame(Shard* shard, Session* session) {
+    restartGame(&session->game, shard->next_seed);
+    shard->next_seed += shard->seed_step;
+    session->playing = true;
+    session->input = INPUT_NONE;
+}
+
+// Function to tell epoll whether the session waits for the socket to take more output
+void watchOutput(Shard* shard, Session* session, bool writing) {
+    if (session->writing == writing) {
+        return;
+    }
+    epoll_event event;
+    event.events = writing ? EPOLLIN | EPOLLOUT : EPOLLIN;
+    event.data.ptr = session;
+    epoll_ctl(shard->epoll_fd, EPOLL_CTL_MOD, session->fd, &event);
+    session->writing = writing;
+}
+
+// Function to send as much of the output as the socket takes, returns false if the client is gone
+bool flushOutput(Shard* shard, Session* session) {
+    while (session->output_sent < session->output_used) {
+        ssize_t sent = send(session->fd, session->output + session->output_sent, session->output_used - session->output_sent, MSG_NOSIGNAL);
+        if (sent > 0) {
+            session->output_sent += sent;
+            shard->bytes_sent.fetch_add(sent, std::memory_order_relaxed);
+        }
+        else if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            watchOutput(shard, session, true);
+            return true;
+        }
+        else {
+            return false;
+        }
+    }
+    session->output_sent = 0;
+    session->output_used = 0;
+    watchOutput(shard, session, false);
+    return true;
+}
+
+// Function to add text to the output, it is dropped if the client doesn't read fast enough
+bool queueOutput(Shard* shard, Session* session, const char* text, int length) {
+    if (session->output_sent > 0) {
+        memmove(session->output, session->output + session->output_sent, session->output_used - session->output_sent);
+        session->output_used -= session->output_sent;
+        session->output_sent = 0;
+    }
+    if (session->output_used + length > MAX_OUTPUT) {
+        return true;
+    }
+    memcpy(session->output + session->output_used, text, length);
+    session->output_used += length;
+    return session->writing || flushOutput(shard, session);
+}
+
+bool sendFrame(Shard* shard, Session* session) {
+    int length = buildFrame(&session->game, session->playing, shard->frame);
+    shard->frames.fetch_add(1, std::memory_order_relaxed);
+    return queueOutput(shard, session, shard->frame, length);
+}
+
+void addSession(Shard* shard, int fd) {
+    makeNonBlocking(fd);
+    int on = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on)); // fails on the Unix sockets, which is fine
+    Session* session = new Session;
+    session->fd = fd;
+    session->index = (int)shard->sessions.size();
+    session->writing = false;
+    session->closed = false;
+    session->parse_state = PARSE_TEXT;
+    session->output_sent = 0;
+    session->output_used = 0;
+    allocateGame(&session->game, &shard->config); // once for every client
+    startGame(shard, session);
+
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.ptr = session;
+    if (epoll_ctl(shard->epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+        freeGame(&session->game);
+        delete session;
+        close(fd);
+        return;
+    }
+    shard->sessions.push_back(session);
+    shard->session_count.store((int)shard->sessions.size(), std::memory_order_relaxed);
+    queueOutput(shard, session, (const char*)TELNET_CHARACTER_MODE, sizeof(TELNET_CHARACTER_MODE));
+    queueOutput(shard, session, HIDE_CURSOR, sizeof(HIDE_CURSOR) - 1);
+    sendFrame(shard, session);
+}
+
+// Function to close the client, the session stays until no event of epoll can point to it
+void closeSession(Shard* shard, Session* session) {
+    if (!session->closed) {
+        session->closed = true;
+        shard->closed.push_back(session);
+    }
+}
+
+// Function to free the game of the closed client, the last session takes its place
+void removeSession(Shard* shard, Session* session) {
+    epoll_ctl(shard->epoll_fd, EPOLL_CTL_DEL, session->fd, NULL);
+    close(session->fd);
+    freeGame(&session->game);
+    Session* last = shard->sessions.back();
+    shard->sessions[session->index] = last;
+    last->index = session->index;
+    shard->sessions.pop_back();
+    shard->session_count.store((int)shard->sessions.size(), std::memory_order_relaxed);
+    delete session;
+}
+
+//***************************
+//* INPUT RELATED FUNCTIONS *
+//***************************
+
+// Function to handle one key of the client, returns false if the client wants to leave
+bool handleKey(Shard* shard, Session* session, int key) {
+    switch (key) {
+    case 'w':
+    case 'W':
+        session->input = INPUT_UP;
+        break;
+    case 's':
+    case 'S':
+        session->input = INPUT_DOWN;
+        break;
+    case 'a':
+    case 'A':
+        session->input = INPUT_LEFT;
+        break;
+    case 'd':
+    case 'D':
+        session->input = INPUT_RIGHT;
+        break;
+    case ' ':
+        session->input = INPUT_FRIENDLY;
+        break;
+    case 'r':
+    case 'R':
+        if (!session->playing) {
+            startGame(shard, session);
+            return sendFrame(shard, session);
+        }
+        break;
+    case 'q':
+    case 'Q':
+    case 3: // Ctrl-C and Ctrl-D in the character mode of telnet
+    case 4:
+        return false;
+    }
+    return true;
+}
+
+// Function to turn the bytes of the client into keys, the arrows and the telnet commands take more than one byte
+bool parseInput(Shard* shard, Session* session, const unsigned char* data, int length) {
+    for (int i = 0; i < length; i++) {
+        unsigned char c = data[i];
+        switch (session->parse_state) {
+        case PARSE_ESCAPE:
+            if (c == '[' || c == 'O') {
+                session->parse_state = PARSE_ARROW;
+                break;
+            }
+            session->parse_state = PARSE_TEXT;
+            i--; // ESC was a key of its own, the byte after it is read again as text
+            break;
+        case PARSE_ARROW:
+            session->parse_state = PARSE_TEXT;
+            if (c >= 'A' && c <= 'D') {
+                const char arrows[] = "wsda"; // up, down, right, left
+                if (!handleKey(shard, session, arrows[c - 'A'])) {
+                    return false;
+                }
+            }
+            break;
+        case PARSE_COMMAND:
+            if (c == TELNET_SB) {
+                session->parse_state = PARSE_SUBOPTION;
+            }
+            else if (c >= 251 && c <= 254) {
+                session->parse_state = PARSE_OPTION;
+            }
+            else {
+                session->parse_state = PARSE_TEXT;
+            }
+            break;
+        case PARSE_OPTION:
+            session->parse_state = PARSE_TEXT;
+            break;
+        case PARSE_SUBOPTION:
+            if (c == TELNET_IAC) {
+                session->parse_state = PARSE_SUBOPTION_END;
+            }
+            break;
+        case PARSE_SUBOPTION_END:
+            session->parse_state = c == TELNET_SE ? PARSE_TEXT : PARSE_SUBOPTION;
+            break;
+        default:
+            if (c == 27) {
+                session->parse_state = PARSE_ESCAPE;
+            }
+            else if (c == TELNET_IAC) {
+                session->parse_state = PARSE_COMMAND;
+            }
+            else if (!handleKey(shard, session, c)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Function to read everything the client sent, returns false if the client is gone
+bool readInput(Shard* shard, Session* session) {
+    unsigned char data[512];
+    while (true) {
+        ssize_t length = recv(session->fd, data, sizeof(data), 0);
+        if (length > 0) {
+            if (!parseInput(shard, session, data, (int)length)) {
+                queueOutput(shard, session, SHOW_CURSOR, sizeof(SHOW_CURSOR) - 1);
+                return false;
+            }
+        }
+        else if (length < 0 && errno == EINTR) {
+            continue;
+        }
+        else if (length < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return true;
+        }
+        else {
+            return false;
+        }
+    }
+}
+
+//*****************
+//* SHARD THREADS *
+//*****************
+
+// Function to take the clients that the main thread accepted for this shard
+void acceptSessions(Shard* shard) {
+    int fds[64];
+    while (true) {
+        ssize_t length = read(shard->wake_fds[0], fds, sizeof(fds));
+        if (length <= 0) {
+            return;
+        }
+        for (int i = 0; i < int(length / sizeof(int)); i++) { // the fds are written whole, a pipe never splits them
+            addSession(shard, fds[i]);
+        }
+    }
+}
+
+// Function to simulate the steps that passed since the last time for every game of the shard
+void stepSessions(Shard* shard) {
+    uint64_t expirations = 0;
+    if (read(shard->timer_fd, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+        return;
+    }
+    int steps = expirations > MAX_CATCH_UP ? MAX_CATCH_UP : (int)expirations;
+    shard->skipped_steps.fetch_add(expirations - steps, std::memory_order_relaxed);
+    long long first_tick = shard->ticks;
+    shard->ticks += expirations;
+    bool frame_due = shard->ticks / shard->frame_interval != first_tick / shard->frame_interval;
+
+    long long simulated = 0;
+    for (size_t s = 0; s < shard->sessions.size(); s++) {
+        Session* session = shard->sessions[s];
+        if (!session->playing || session->closed) {
+            continue;
+        }
+        int status = GAME_RUNNING;
+        for (int i = 0; i < steps && status != GAME_OVER && status != GAME_WON; i++) {
+            status = step(&session->game, session->input);
+            session->input = INPUT_NONE;
+            simulated++;
+        }
+        session->playing = status != GAME_OVER && status != GAME_WON;
+        if ((frame_due || !session->playing) && !sendFrame(shard, session)) {
+            closeSession(shard, session);
+        }
+    }
+    shard->steps.fetch_add(simulated, std::memory_order_relaxed);
+}
+
+void runShard(Shard* shard) {
+    epoll_event events[MAX_EVENTS];
+    while (!stopping) {
+        int count = epoll_wait(shard->epoll_fd, events, MAX_EVENTS, 100);
+        for (int i = 0; i < count; i++) {
+            if (events[i].data.ptr == &shard->timer_fd) {
+                stepSessions(shard);
+            }
+            else if (events[i].data.ptr == &shard->wake_fds[0]) {
+                acceptSessions(shard);
+            }
+            else {
+                Session* session = (Session*)events[i].data.ptr;
+                if (session->closed) {
+                    continue;
+                }
+                bool alive = (events[i].events & (EPOLLERR | EPOLLHUP)) == 0;
+                if (alive && (events[i].events & EPOLLIN)) {
+                    alive = readInput(shard, session);
+                }
+                if (alive && (events[i].events & EPOLLOUT)) {
+                    alive = flushOutput(shard, session);
+                }
+                if (!alive) {
+                    flushOutput(shard, session); // the last words, if the socket takes them
+                    closeSession(shard, session);
+                }
+            }
+        }
+        for (size_t i = 0; i < shard->closed.size(); i++) {
+            removeSession(shard, shard->closed[i]);
+        }
+        shard->closed.clear();
+    }
+    while (!shard->sessions.empty()) {
+        Session* session = shard->sessions.back();
+        queueOutput(shard, session, SHOW_CURSOR, sizeof(SHOW_CURSOR) - 1);
+        removeSession(shard, session);
+    }
+}
+
+// Function to make the epoll, the timer and the pipe of the shard, returns false on error
+bool initShard(Shard* shard, int index, int threads, const GameConfig* config) {
+    shard->index = index;
+    shard->config = *config;
+    shard->next_seed = config->seed + index;
+    shard->seed_step = threads;
+    shard->ticks = 0;
+    shard->frame_interval = config->tick_rate / FRAME_RATE > 0 ? config->tick_rate / FRAME_RATE : 1;
+    shard->session_count = 0;
+    shard->steps = 0;
+    shard->skipped_steps = 0;
+    shard->frames = 0;
+    shard->bytes_sent = 0;
+    shard->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    shard->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (shard->epoll_fd < 0 || shard->timer_fd < 0 || pipe2(shard->wake_fds, O_NONBLOCK | O_CLOEXEC) != 0) {
+        return false;
+    }
+    // the main thread must not be stuck on a full pipe, the shard empties it soon anyway
+    int flags = fcntl(shard->wake_fds[1], F_GETFL, 0);
+    fcntl(shard->wake_fds[1], F_SETFL, flags & ~O_NONBLOCK);
+
+    itimerspec interval;
+    long long step_time = 1000000000LL / config->tick_rate; // in nanoseconds
+    interval.it_interval.tv_sec = step_time / 1000000000LL;
+    interval.it_interval.tv_nsec = step_time % 1000000000LL;
+    interval.it_value = interval.it_interval;
+    timerfd_settime(shard->timer_fd, 0, &interval, NULL);
+
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.ptr = &shard->timer_fd;
+    epoll_ctl(shard->epoll_fd, EPOLL_CTL_ADD, shard->timer_fd, &event);
+    event.data.ptr = &shard->wake_fds[0];
+    epoll_ctl(shard->epoll_fd, EPOLL_CTL_ADD, shard->wake_fds[0], &event);
+    return true;
+}
+
+void freeShard(Shard* shard) {
+    close(shard->epoll_fd);
+    close(shard->timer_fd);
+    close(shard->wake_fds[0]);
+    close(shard->wake_fds[1]);
+}
+
+//***********************
+//* ACCEPTING NEW GAMES *
+//***********************
+
+// Function to accept every waiting client and hand them to the shards in turn
+void acceptClients(int listen_fd, Shard* shards, int threads, int* next_shard) {
+    while (true) {
+        int fd = accept4(listen_fd, NULL, NULL, SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EMFILE || errno == ENFILE) {
+                printf("Error: too many open files, raise ulimit -n\n");
+                usleep(100000); // the client stays in the queue, it is accepted when a game ends
+            }
+            return;
+        }
+        Shard* shard = &shards[*next_shard];
+        *next_shard = (*next_shard + 1) % threads;
+        if (write(shard->wake_fds[1], &fd, sizeof(fd)) != sizeof(fd)) {
+            close(fd);
+        }
+    }
+}
+
+void printStats(Shard* shards, int threads, long long* last_steps, long long* last_frames, long long* last_bytes, double seconds) {
+    int sessions = 0;
+    long long steps = 0;
+    long long skipped = 0;
+    long long frames = 0;
+    long long bytes = 0;
+    for (int i = 0; i < threads; i++) {
+        sessions += shards[i].session_count.load(std::memory_order_relaxed);
+        steps += shards[i].steps.load(std::memory_order_relaxed);
+        skipped += shards[i].skipped_steps.load(std::memory_order_relaxed);
+        frames += shards[i].frames.load(std::memory_order_relaxed);
+        bytes += shards[i].bytes_sent.load(std::memory_order_relaxed);
+    }
+    printf("sessions: %d, steps/s: %.0f, frames/s: %.0f, sent: %.2f MB/s, steps skipped so far: %lld\n", sessions,
+           (steps - *last_steps) / seconds, (frames - *last_frames) / seconds, (bytes - *last_bytes) / seconds / 1e6, skipped);
+    fflush(stdout);
+    *last_steps = steps;
+    *last_frames = frames;
+    *last_bytes = bytes;
+}
+
+double monotonicTime() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+//*****************
+//* MAIN FUNCTION *
+//*****************
+
+int main(int argc, char** argv) {
+    int port = DEFAULT_PORT;
+    const char* unix_path = NULL;
+    int threads = (int)std::thread::hardware_concurrency();
+    if (threads < 1) {
+        threads = 1;
+    }
+
+    GameConfig config;
+    config.frog_speed = 3; // the same values as in the default config.txt
+    config.car_min_speed = 1;
+    config.car_max_speed = 5;
+    config.rows = DEFAULT_ROWS;
+    config.cols = DEFAULT_COLS;
+    config.tick_rate = DEFAULT_TICK_RATE;
+    config.cars_per_road = 1;
+    config.seed = (unsigned long long)time(NULL);
+    config.background_levels = false; // the shards are busy enough, a level is made on the shard's thread
+    int board_rows = 0;
+    int board_cols = 0;
+    openConfigFile(&config.frog_speed, &config.car_min_speed, &config.car_max_speed, &config.tick_rate, &board_rows, &board_cols, &config.cars_per_road);
+    if (board_rows > 0 && board_cols > 0) { // 0 means the size of the terminal, the clients' terminals aren't known
+        config.rows = board_rows;
+        config.cols = board_cols;
+    }
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--port") == 0) {
+            port = atoi(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--unix") == 0) {
+            unix_path = argv[i + 1];
+        }
+        else if (strcmp(argv[i], "--threads") == 0) {
+            threads = atoi(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--rows") == 0) {
+            config.rows = atoi(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--cols") == 0) {
+            config.cols = atoi(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--seed") == 0) {
+            config.seed = strtoull(argv[i + 1], NULL, 10);
+        }
+        else {
+            printf("Unknown option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (config.rows < 4 || config.cols < 3) {
+        printf("Error: the board has to be at least 4x3!\n");
+        return 1;
+    }
+    if (threads < 1) {
+        threads = 1;
+    }
+    if (config.cars_per_road < 1) {
+        config.cars_per_road = 1;
+    }
+    if (config.tick_rate <= 0) {
+        config.tick_rate = DEFAULT_TICK_RATE;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    raiseFileLimit();
+
+    int listen_fds[2];
+    int listeners = 0;
+    if (port > 0) {
+        listen_fds[listeners] = listenTcp(port);
+        if (listen_fds[listeners] < 0) {
+            printf("Error: can't listen on port %d!\n", port);
+            return 1;
+        }
+        listeners++;
+    }
+    if (unix_path != NULL) {
+        listen_fds[listeners] = listenUnix(unix_path);
+        if (listen_fds[listeners] < 0) {
+            printf("Error: can't listen on %s!\n", unix_path);
+            return 1;
+        }
+        listeners++;
+    }
+    if (listeners == 0) {
+        printf("Error: nothing to listen on, give --port or --unix!\n");
+        return 1;
+    }
+
+    Shard* shards = new Shard[threads];
+    for (int i = 0; i < threads; i++) {
+        if (!initShard(&shards[i], i, threads, &config)) {
+            printf("Error: can't start shard %d!\n", i);
+            return 1;
+        }
+    }
+    for (int i = 0; i < threads; i++) {
+        shards[i].thread = std::thread(runShard, &shards[i]);
+    }
+
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    for (int i = 0; i < listeners; i++) {
+        epoll_event event;
+        event.events = EPOLLIN;
+        event.data.fd = listen_fds[i];
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fds[i], &event);
+    }
+    printf("board: %dx%d, threads: %d", config.rows, config.cols, threads);
+    if (port > 0) {
+        printf(", port: %d", port);
+    }
+    if (unix_path != NULL) {
+        printf(", socket: %s", unix_path);
+    }
+    printf("\n");
+    fflush(stdout);
+
+    int next_shard = 0;
+    long long last_steps = 0;
+    long long last_frames = 0;
+    long long last_bytes = 0;
+    double last_stats = monotonicTime();
+    while (!stopping) {
+        epoll_event events[2];
+        int count = epoll_wait(epoll_fd, events, 2, 1000);
+        for (int i = 0; i < count; i++) {
+            acceptClients(events[i].data.fd, shards, threads, &next_shard);
+        }
+        double now = monotonicTime();
+        if (now - last_stats >= STATS_INTERVAL) {
+            printStats(shards, threads, &last_steps, &last_frames, &last_bytes, now - last_stats);
+            last_stats = now;
+        }
+    }
+
+    for (int i = 0; i < threads; i++) {
+        shards[i].thread.join();
+        freeShard(&shards[i]);
+    }
+    delete[] shards;
+    for (int i = 0; i < listeners; i++) {
+        close(listen_fds[i]);
+    }
+    close(epoll_fd);
+    if (unix_path != NULL) {
+        unlink(unix_path);
+    }
+    return 0;
+}
@@ -0,0 +1,139 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - checking if a level can be won
+    Version: 1.0
+
+    The frog is simulated forward one move at a time, but instead of one
+    frog every cell in which a frog could be is kept, as one row of bits for
+    every row of the board, so a whole row moves with a few word operations.
+    A cell is lost when a car drives over it while the frog waits there. The
+    positions of the cars in any step follow from their next move and speed,
+    nothing is stored for the time. The search is bounded and leaves some
+    things out, so it can be wrong both ways:
+    - a level is lost after SOLVER_MOVES_PER_ROW moves for every row (and
+      one for every column), even if a slower way would get through,
+    - only SOLVER_ROWS rows below the highest row reached are followed, a
+      way that goes back further down is missed,
+    - the cars that are on the board keep driving and come back on the
+      other edge, the cars that come later (with more than one car on a
+      road) aren't known yet, and the stork, the friendly cars and the
+      speed changes are left out.
+*/
+
+#include <string.h>
+#include "solver.h"
+
+//*****************
+//* CAR POSITIONS *
+//*****************
+
+// Function to count how many times the car moved by the given step, it moves in next_move, next_move + interval, ...
+long long carMoves(const CarStore* cars, int i, long long tick) {
+    if (tick < cars->next_move[i]) {
+        return 0;
+    }
+    return (tick - cars->next_move[i]) / cars->move_interval[i] + 1;
+}
+
+// Function to mark the cells that the cars of the road drive over in the steps from ... to
+void carCells(const Board* board, int road, long long from, long long to, uint64_t* out) {
+    const CarStore* cars = &board->cars;
+    int width = board->cols - 1;
+    memset(out, 0, board->words * sizeof(uint64_t));
+    for (int j = 0; j < board->roads[road].count; j++) {
+        int i = laneSlot(board, road, j);
+        long long first = carMoves(cars, i, from);
+        long long cells = carMoves(cars, i, to) - first + 1; // the cell in the step from and every move after it
+        if (cells > width) {
+            cells = width;
+        }
+        long long y = cars->y[i] + cars->direction[i] * (first % width);
+        for (long long k = 0; k < cells; k++) {
+            setBit(out, int((y % width + width) % width));
+            y += cars->direction[i];
+        }
+    }
+}
+
+//**********************
+//* SEARCHING THE GAME *
+//**********************
+
+size_t solverMemorySize(int rows, int cols) {
+    int words = (cols + 63) / 64;
+    return 2 * arenaSpace((size_t)rows * words * sizeof(uint64_t)) + 2 * arenaSpace(words * sizeof(uint64_t));
+}
+
+// Function to check if the frog can get from the start to the end of the level in the given step, with every move
+// it can go to a neighbouring cell or stay. Only the rows near the highest row reached are followed, and after
+// SOLVER_MOVES_PER_ROW moves for every row the level counts as not possible to win.
+// The rows of bits are taken from the arena of the board and given back at the end
+bool levelSolvable(Board* board, int frog_speed, long long tick) {
+    size_t arena_used = board->arena.used;
+    int words = board->words;
+    size_t bytes = (size_t)board->rows * words * sizeof(uint64_t);
+    uint64_t* now = (uint64_t*)arenaAlloc(&board->arena, bytes);
+    uint64_t* next = (uint64_t*)arenaAlloc(&board->arena, bytes);
+    uint64_t* cars = (uint64_t*)arenaAlloc(&board->arena, words * sizeof(uint64_t));
+    uint64_t* columns = (uint64_t*)arenaAlloc(&board->arena, words * sizeof(uint64_t)); // the columns of the frog
+    memset(now, 0, bytes);
+    memset(next, 0, bytes);
+    memset(columns, 0, words * sizeof(uint64_t));
+    for (int j = 0; j < board->cols - 1; j++) {
+        setBit(columns, j);
+    }
+    int interval = moveInterval(frog_speed, board->tick_rate); // steps between two moves of the frog
+    setBit(now + (size_t)(board->rows - 1) * words, board->cols / 2);
+    int top = board->rows - 1; // the highest row that was reached
+    int max_moves = SOLVER_MOVES_PER_ROW * board->rows + board->cols;
+
+    bool solvable = false;
+    bool alive = true;
+    for (int move = 0; move < max_moves && alive && !solvable; move++) {
+        long long from = tick + (long long)move * interval; // the frog stays in its cell in these steps
+        long long to = from + interval - 1;
+        int first = top > 0 ? top - 1 : 0;
+        int last = top + SOLVER_ROWS < board->rows - 1 ? top + SOLVER_ROWS : board->rows - 1;
+        alive = false; // false if every frog was run over
+        for (int x = first; x <= last; x++) {
+            const uint64_t* here = now + (size_t)x * words;
+            const uint64_t* below = x + 1 <= last ? here + words : NULL; // the frog moves up from the row below
+            const uint64_t* above = x - 1 >= first ? here - words : NULL;
+            bool road = board->occupancy.road_of_row[x] >= 0;
+            if (road) {
+                carCells(board, board->occupancy.road_of_row[x], from, to, cars);
+            }
+            uint64_t* out = next + (size_t)x * words;
+            const uint64_t* obstacles = obstacleBits(board, x);
+            uint64_t any = 0;
+            for (int w = 0; w < words; w++) {
+                uint64_t bits = here[w];
+                uint64_t left = w > 0 ? here[w - 1] >> 63 : 0;
+                uint64_t right = w + 1 < words ? here[w + 1] << 63 : 0;
+                bits |= (bits << 1) | left | (bits >> 1) | right;
+                if (below != NULL) {
+                    bits |= below[w];
+                }
+                if (above != NULL) {
+                    bits |= above[w];
+                }
+                bits &= ~obstacles[w] & columns[w];
+                if (road) {
+                    bits &= ~cars[w];
+                }
+                out[w] = bits;
+                any |= bits;
+            }
+            if (any != 0) {
+                alive = true;
+                solvable |= x == 0; // the frog got to the end
+                top = x < top ? x : top;
+            }
+        }
+        uint64_t* swap = now;
+        now = next;
+        next = swap;
+    }
+    board->arena.used = arena_used;
+    return solvable;
+}
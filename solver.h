@@ -0,0 +1,27 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - checking if a level can be won
+    Version: 1.0
+*/
+
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <stddef.h>
+#include "engine.h"
+
+//**********************
+//* DEFINING CONSTANTS *
+//**********************
+
+#define SOLVER_ROWS 32 // ONLY THIS MANY ROWS BELOW THE HIGHEST ROW THAT WAS REACHED ARE FOLLOWED
+#define SOLVER_MOVES_PER_ROW 8 // THE FROG HAS TO GET TO THE END IN THIS MANY MOVES FOR EVERY ROW (AND ONE FOR EVERY COLUMN)
+
+//********************
+//* SOLVER FUNCTIONS *
+//********************
+
+size_t solverMemorySize(int rows, int cols);
+bool levelSolvable(Board* board, int frog_speed, long long tick);
+
+#endif
@@ -0,0 +1,346 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - difficulty sweep
+    Version: 1.0
+
+    Plays many seeded games for every combination of the speeds from
+    config.txt and shows how hard every combination is. The games are split
+    into small tasks that a pool of threads takes from each other's queues,
+    so the threads stay busy even though some games are much longer than
+    others. Usage:
+        frog-sweep [--games N] [--seed S] [--threads T] [--rows R] [--cols C] [--max-time T]
+                   [--frog-speed FROM:TO[:STEP]] [--car-min FROM:TO[:STEP]] [--car-max FROM:TO[:STEP]]
+
+    Game g of every combination uses the seed S + g, the same as game g of
+    frog-headless, and the results don't depend on the number of threads.
+*/
+
+#include <algorithm>
+#include <mutex>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <time.h>
+#include <vector>
+#include "engine.h"
+#include "policy.h"
+
+//**********************
+//* DEFINING CONSTANTS *
+//**********************
+
+#define DEFAULT_GAMES 1000 // GAMES FOR EVERY COMBINATION OF THE SPEEDS
+#define DEFAULT_ROWS 26
+#define DEFAULT_COLS 50
+#define DEFAULT_MAX_TIME 300
+#define GAMES_PER_TASK 25 // SMALL ENOUGH TO SPREAD THE WORK, BIG ENOUGH TO NOT FIGHT OVER THE QUEUES
+
+//***********************
+//* DEFINING STRUCTURES *
+//***********************
+
+struct Range { // Values FROM, FROM + STEP, ... up to TO
+    int from;
+    int to;
+    int step;
+};
+
+struct SweepPoint { // One combination of the speeds and the results of its games
+    GameConfig config;
+    int* status; // Result of every game
+    int* points;
+    double* time;
+};
+
+struct Task { // Games first .. first + count - 1 of one combination
+    int point;
+    int first;
+    int count;
+};
+
+struct TaskQueue { // The owner takes the tasks from the back, the other threads steal them from the front
+    std::mutex lock;
+    std::vector<Task> tasks;
+    size_t front;
+};
+
+struct Sweep {
+    SweepPoint* points;
+    int num_points;
+    TaskQueue* queues; // One queue for every thread
+    int num_threads;
+    unsigned int seed;
+    double max_time;
+};
+
+//***********
+//* OPTIONS *
+//***********
+
+// Function to read FROM:TO[:STEP], a single number is a range of one value
+bool parseRange(const char* text, Range* range) {
+    int step = 1;
+    int n = sscanf(text, "%d:%d:%d", &range->from, &range->to, &step);
+    if (n == 1) {
+        range->to = range->from;
+    }
+    range->step = step;
+    return n >= 1 && range->step > 0 && range->from <= range->to;
+}
+
+//************************
+//* TASK QUEUE FUNCTIONS *
+//************************
+
+// Function to take a task from the back of the own queue
+bool popTask(TaskQueue* queue, Task* task) {
+    std::lock_guard<std::mutex> guard(queue->lock);
+    if (queue->tasks.size() == queue->front) {
+        return false;
+    }
+    *task = queue->tasks.back();
+    queue->tasks.pop_back();
+    return true;
+}
+
+// Function to take a task from the front of the queue of another thread
+bool stealTask(TaskQueue* queue, Task* task) {
+    std::lock_guard<std::mutex> guard(queue->lock);
+    if (queue->tasks.size() == queue->front) {
+        return false;
+    }
+    *task = queue->tasks[queue->front++];
+    return true;
+}
+
+// Function to find the next task, the own queue first and then the others
+bool nextTask(Sweep* sweep, int self, Task* task) {
+    if (popTask(&sweep->queues[self], task)) {
+        return true;
+    }
+    for (int i = 1; i < sweep->num_threads; i++) {
+        if (stealTask(&sweep->queues[(self + i) % sweep->num_threads], task)) {
+            return true;
+        }
+    }
+    return false; // no task is ever added, so all the queues are empty for good
+}
+
+//*****************
+//* PLAYING GAMES *
+//*****************
+
+// Function to play the games of one task, every game writes only its own results
+void runTask(Sweep* sweep, const Task* task) {
+    SweepPoint* point = &sweep->points[task->point];
+    for (int g = task->first; g < task->first + task->count; g++) {
+        Game game;
+        GameConfig config = point->config;
+        config.seed = (unsigned long long)sweep->seed + g;
+        initGame(&game, &config);
+        long long max_ticks = (long long)(sweep->max_time * game.config.tick_rate);
+        while (game.status == GAME_RUNNING && game.tick < max_ticks) {
+            step(&game, greedyPolicy(&game));
+        }
+        point->status[g] = game.status;
+        point->points[g] = CalculatePoints(game.frog, game.timer);
+        point->time[g] = game.timer->current_time;
+        freeGame(&game);
+    }
+}
+
+void worker(Sweep* sweep, int self) {
+    Task task;
+    while (nextTask(sweep, self, &task)) {
+        runTask(sweep, &task);
+    }
+}
+
+//***********
+//* RESULTS *
+//***********
+
+// Function to get the value below which the given part of the sorted points are
+int percentile(const std::vector<int>& sorted, double part) {
+    size_t i = (size_t)(part * (sorted.size() - 1) + 0.5);
+    return sorted[i];
+}
+
+void printPoint(const SweepPoint* point, int games) {
+    int wins = 0;
+    int losses = 0;
+    double lost_time = 0.0; // how long the frog survived in the games that it lost
+    double points_sum = 0.0;
+    std::vector<int> sorted(point->points, point->points + games);
+    std::sort(sorted.begin(), sorted.end());
+    for (int g = 0; g < games; g++) {
+        if (point->status[g] == GAME_WON) {
+            wins++;
+        }
+        else if (point->status[g] == GAME_OVER) {
+            losses++;
+            lost_time += point->time[g];
+        }
+        points_sum += point->points[g];
+    }
+    printf("%5d %7d %7d | %6.1f%% %6.1f%% %8.2f | %8.1f %6d %6d %6d %6d\n",
+        point->config.frog_speed, point->config.car_min_speed, point->config.car_max_speed,
+        100.0 * wins / games, 100.0 * (games - wins - losses) / games, losses > 0 ? lost_time / losses : 0.0,
+        points_sum / games, percentile(sorted, 0.1), percentile(sorted, 0.5), percentile(sorted, 0.9), sorted.back());
+}
+
+//*****************
+//* MAIN FUNCTION *
+//*****************
+
+int main(int argc, char** argv) {
+    int games = DEFAULT_GAMES;
+    int num_threads = (int)std::thread::hardware_concurrency();
+    Range frog_speed = { 2, 10, 2 }; // the ranges allowed by config.txt
+    Range car_min = { 1, 9, 2 };
+    Range car_max = { 2, 20, 3 };
+
+    GameConfig config;
+    config.frog_speed = 3;
+    config.car_min_speed = 1;
+    config.car_max_speed = 5;
+    config.rows = DEFAULT_ROWS;
+    config.cols = DEFAULT_COLS;
+    config.tick_rate = DEFAULT_TICK_RATE;
+    config.cars_per_road = 1;
+    config.background_levels = false; // every thread already plays its own games
+    config.seed = 0;
+    int board_rows = 0;
+    int board_cols = 0;
+    openConfigFile(&config.frog_speed, &config.car_min_speed, &config.car_max_speed, &config.tick_rate, &board_rows, &board_cols, &config.cars_per_road); // only the tick rate, the board size and the cars per road are kept
+    if (board_rows > 0 && board_cols > 0) { // 0 means the size of the terminal, which there isn't here
+        config.rows = board_rows;
+        config.cols = board_cols;
+    }
+
+    Sweep sweep;
+    sweep.seed = (unsigned int)time(NULL);
+    sweep.max_time = DEFAULT_MAX_TIME;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        bool ok = true;
+        if (strcmp(argv[i], "--games") == 0) {
+            games = atoi(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--seed") == 0) {
+            sweep.seed = (unsigned int)strtoul(argv[i + 1], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--threads") == 0) {
+            num_threads = atoi(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--rows") == 0) {
+            config.rows = atoi(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--cols") == 0) {
+            config.cols = atoi(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--max-time") == 0) {
+            sweep.max_time = atof(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--frog-speed") == 0) {
+            ok = parseRange(argv[i + 1], &frog_speed);
+        }
+        else if (strcmp(argv[i], "--car-min") == 0) {
+            ok = parseRange(argv[i + 1], &car_min);
+        }
+        else if (strcmp(argv[i], "--car-max") == 0) {
+            ok = parseRange(argv[i + 1], &car_max);
+        }
+        else {
+            printf("Unknown option: %s\n", argv[i]);
+            return 1;
+        }
+        if (!ok) {
+            printf("Error: %s needs FROM:TO[:STEP] with FROM <= TO\n", argv[i]);
+            return 1;
+        }
+    }
+    if (config.rows < 4 || config.cols < 3 || games < 1) {
+        printf("Error: the board has to be at least 4x3 and there has to be at least one game!\n");
+        return 1;
+    }
+    if (num_threads < 1) {
+        num_threads = 1;
+    }
+
+    // making the grid, the maximum car speed has to be greater than the minimum one
+    std::vector<SweepPoint> points;
+    for (int f = frog_speed.from; f <= frog_speed.to; f += frog_speed.step) {
+        for (int lo = car_min.from; lo <= car_min.to; lo += car_min.step) {
+            for (int hi = car_max.from; hi <= car_max.to; hi += car_max.step) {
+                if (hi <= lo || f <= 0 || lo <= 0) {
+                    continue;
+                }
+                SweepPoint point;
+                point.config = config;
+                point.config.frog_speed = f;
+                point.config.car_min_speed = lo;
+                point.config.car_max_speed = hi;
+                point.status = new int[games];
+                point.points = new int[games];
+                point.time = new double[games];
+                points.push_back(point);
+            }
+        }
+    }
+    if (points.empty()) {
+        printf("Error: no combination has the maximum car speed greater than the minimum one!\n");
+        return 1;
+    }
+    sweep.points = &points[0];
+    sweep.num_points = (int)points.size();
+    sweep.num_threads = num_threads;
+    sweep.queues = new TaskQueue[num_threads];
+
+    // dealing the tasks out in turns, so every thread starts with every kind of combination
+    int next_queue = 0;
+    for (int p = 0; p < sweep.num_points; p++) {
+        for (int first = 0; first < games; first += GAMES_PER_TASK) {
+            Task task;
+            task.point = p;
+            task.first = first;
+            task.count = std::min(GAMES_PER_TASK, games - first);
+            sweep.queues[next_queue].tasks.push_back(task);
+            next_queue = (next_queue + 1) % num_threads;
+        }
+    }
+    for (int i = 0; i < num_threads; i++) {
+        sweep.queues[i].front = 0;
+    }
+
+    timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    std::vector<std::thread> threads;
+    for (int i = 1; i < num_threads; i++) {
+        threads.push_back(std::thread(worker, &sweep, i));
+    }
+    worker(&sweep, 0); // the main thread works too
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+    timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double wall_time = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    printf("seed: %u\n", sweep.seed);
+    printf("board: %dx%d, %d games for each of %d combinations, %d threads\n", config.rows, config.cols, games, sweep.num_points, num_threads);
+    printf(" frog car_min car_max |    won  timeout lost at s |  avg pts    p10    p50    p90    max\n");
+    for (int p = 0; p < sweep.num_points; p++) {
+        printPoint(&points[p], games);
+    }
+    long long total_games = (long long)games * sweep.num_points;
+    printf("games: %lld in %.2f s (%.0f games per second)\n", total_games, wall_time, wall_time > 0 ? total_games / wall_time : 0.0);
+
+    for (int p = 0; p < sweep.num_points; p++) {
+        delete[] points[p].status;
+        delete[] points[p].points;
+        delete[] points[p].time;
+    }
+    delete[] sweep.queues;
+    return 0;
+}
@@ -0,0 +1,672 @@
+/*
+    Author: Jan Rudnicki
+    Program: Jumping Frog - tests
+    Version: 1.0
+
+    Checks of the fast parts of the engine against simple versions of them
+    that are easy to trust: plain searches over the cells instead of the
+    bitsets. Usage:
+        frog-tests NAME
+    NAME is one of the tests below, every one is a test of ctest. A check
+    that fails prints what it expected, the exit code is 1 if any failed.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include "engine.h"
+#include "keyboard.h"
+#include "rewind.h"
+#include "solver.h"
+
+//**********************
+//* DEFINING CONSTANTS *
+//**********************
+
+#define TEST_SEED 1
+
+//**********
+//* CHECKS *
+//**********
+
+int failures = 0;
+
+// Function to count and show a check that failed, only the first few are shown
+void fail(const char* what, long long expected, long long got) {
+    if (failures < 20) {
+        printf("FAILED: %s, expected %lld, got %lld\n", what, expected, got);
+    }
+    failures++;
+}
+
+uint64_t test_random = 0x2545F4914F6CDD1DULL;
+
+// Random number from 0 to n - 1 for the tests, independent of the engine
+int testRandom(int n) {
+    test_random ^= test_random << 13;
+    test_random ^= test_random >> 7;
+    test_random ^= test_random << 17;
+    return int(test_random % (uint64_t)n);
+}
+
+// Function to make a random level of the given size on a new board
+void makeBoard(Board* board, int rows, int cols, int min_speed, int max_speed, int cars_per_road, unsigned long long seed) {
+    initArena(&board->arena, boardMemorySize(rows, cols, cars_per_road));
+    seedRandom(board, seed);
+    initBoard(board, rows, cols, min_speed, max_speed, DEFAULT_TICK_RATE, 0, 0, cars_per_road, 0);
+}
+
+//*****************************
+//* DISTANCE FIELD OF A STORK *
+//*****************************
+
+// Function to find the moves from the frog to every cell of the rectangle with a plain breadth-first search,
+// one cell at a time, to the 8 neighbours that aren't obstacles. -1 for the cells that can't be reached
+void plainDistances(const Board* board, int frog_x, int frog_y, int min_x, int max_x, int min_y, int max_y, int* out) {
+    int width = max_y - min_y + 1;
+    int cells = (max_x - min_x + 1) * width;
+    int* queue = new int[cells];
+    for (int i = 0; i < cells; i++) {
+        out[i] = -1;
+    }
+    int first = 0;
+    int last = 0;
+    out[(frog_x - min_x) * width + frog_y - min_y] = 0;
+    queue[last++] = (frog_x - min_x) * width + frog_y - min_y;
+    while (first < last) {
+        int cell = queue[first++];
+        int x = cell / width + min_x;
+        int y = cell % width + min_y;
+        for (int dx = -1; dx <= 1; dx++) {
+            for (int dy = -1; dy <= 1; dy++) {
+                int nx = x + dx;
+                int ny = y + dy;
+                if (nx < min_x || nx > max_x || ny < min_y || ny > max_y || isObstacle(board, nx, ny)) {
+                    continue;
+                }
+                int next = (nx - min_x) * width + ny - min_y;
+                if (out[next] < 0) {
+                    out[next] = out[cell] + 1;
+                    queue[last++] = next;
+                }
+            }
+        }
+    }
+    delete[] queue;
+}
+
+// The distances of storkDistance for every cell near frogs in random cells, asked in a random order so
+// the field grows one layer at a time, against the plain search
+void testField() {
+    const int sizes[][2] = { { 6, 5 }, { 26, 50 }, { 40, 150 }, { 200, 300 } }; // the field is smaller than the last ones
+    for (int s = 0; s < 4; s++) {
+        for (int level = 0; level < 5; level++) {
+            Board board;
+            makeBoard(&board, sizes[s][0], sizes[s][1], 1, 5, 1, TEST_SEED + level);
+            for (int frogs = 0; frogs < 10; frogs++) {
+                Object frog;
+                do {
+                    frog.x = testRandom(board.rows);
+                    frog.y = testRandom(board.cols - 1);
+                } while (isObstacle(&board, frog.x, frog.y));
+                if (storkDistance(&board, &frog, frog.x, frog.y) != 0) {
+                    fail("distance of the frog to itself", 0, storkDistance(&board, &frog, frog.x, frog.y));
+                }
+                const DistanceField* field = &board.stork_field;
+                int min_x = field->min_x;
+                int max_x = field->max_x;
+                int min_y = field->min_y;
+                int max_y = field->max_y;
+                int width = max_y - min_y + 1;
+                int cells = (max_x - min_x + 1) * width;
+                int* expected = new int[cells];
+                plainDistances(&board, frog.x, frog.y, min_x, max_x, min_y, max_y, expected);
+                int* order = new int[cells];
+                for (int i = 0; i < cells; i++) {
+                    order[i] = i;
+                }
+                for (int i = cells - 1; i > 0; i--) {
+                    int j = testRandom(i + 1);
+                    int swap = order[i];
+                    order[i] = order[j];
+                    order[j] = swap;
+                }
+                for (int i = 0; i < cells; i++) {
+                    int x = order[i] / width + min_x;
+                    int y = order[i] % width + min_y;
+                    int got = storkDistance(&board, &frog, x, y);
+                    if (got != expected[order[i]]) {
+                        fail("distance of a cell of the field", expected[order[i]], got);
+                    }
+                }
+                if (min_x > 0 && storkDistance(&board, &frog, min_x - 1, frog.y) != -1) {
+                    fail("distance of a cell above the field", -1, storkDistance(&board, &frog, min_x - 1, frog.y));
+                }
+                if (max_y < board.cols - 2 && storkDistance(&board, &frog, frog.x, max_y + 1) != -1) {
+                    fail("distance of a cell right of the field", -1, storkDistance(&board, &frog, frog.x, max_y + 1));
+                }
+                delete[] order;
+                delete[] expected;
+            }
+            freeArena(&board.arena);
+        }
+    }
+}
+
+//**********************************
+//* CHECKING IF A LEVEL CAN BE WON *
+//**********************************
+
+// Function to check if a level can be won the way levelSolvable does it, but with one bool for every cell and the
+// cars moved one step at a time: a frog moves every interval steps to a neighbouring cell or stays, and is lost
+// when a car is in its cell in any step that it waits there. The cars come back on the other edge
+bool plainSolvable(const Board* board, int frog_speed, long long tick) {
+    const CarStore* cars = &board->cars;
+    int rows = board->rows;
+    int width = board->cols - 1;
+    int interval = moveInterval(frog_speed, board->tick_rate);
+    long long* position = new long long[cars->count];
+    long long* next_move = new long long[cars->count];
+    for (int i = 0; i < cars->count; i++) {
+        position[i] = cars->y[i];
+        next_move[i] = cars->next_move[i];
+    }
+    bool* now = new bool[rows * width];
+    bool* next = new bool[rows * width];
+    bool* hit = new bool[rows * width];
+    memset(now, 0, rows * width);
+    now[(rows - 1) * width + board->cols / 2] = true;
+    int max_moves = SOLVER_MOVES_PER_ROW * rows + board->cols;
+    bool solvable = false;
+    bool alive = true;
+    for (int move = 0; move < max_moves && alive && !solvable; move++) {
+        long long from = tick + (long long)move * interval;
+        memset(hit, 0, rows * width);
+        for (long long t = from; t < from + interval; t++) {
+            for (int i = 0; i < cars->count; i++) {
+                if (!cars->active[i]) {
+                    continue;
+                }
+                while (next_move[i] <= t) {
+                    position[i] += cars->direction[i];
+                    next_move[i] += cars->move_interval[i];
+                }
+                hit[cars->x[i] * width + int((position[i] % width + width) % width)] = true;
+            }
+        }
+        alive = false;
+        for (int x = 0; x < rows; x++) {
+            for (int y = 0; y < width; y++) {
+                bool reached = now[x * width + y] || (y > 0 && now[x * width + y - 1]) || (y + 1 < width && now[x * width + y + 1])
+                    || (x > 0 && now[(x - 1) * width + y]) || (x + 1 < rows && now[(x + 1) * width + y]);
+                next[x * width + y] = reached && !isObstacle(board, x, y) && !hit[x * width + y];
+                alive |= next[x * width + y];
+                solvable |= next[x * width + y] && x == 0;
+            }
+        }
+        bool* swap = now;
+        now = next;
+        next = swap;
+    }
+    delete[] position;
+    delete[] next_move;
+    delete[] now;
+    delete[] next;
+    delete[] hit;
+    return solvable;
+}
+
+// levelSolvable against the plain search on small boards (not taller than SOLVER_ROWS, so no rows are left out),
+// with slow and fast cars, one or more of them on a road, and the search started in later steps
+void testSolver() {
+    const int sizes[][2] = { { 8, 10 }, { 12, 20 }, { 20, 70 }, { 30, 40 } };
+    const int speeds[][2] = { { 1, 3 }, { 1, 5 }, { 4, 10 }, { 8, 20 } };
+    int solvable = 0;
+    int unsolvable = 0;
+    for (int s = 0; s < 4; s++) {
+        for (int c = 0; c < 4; c++) {
+            for (int level = 0; level < 6; level++) {
+                Board board;
+                makeBoard(&board, sizes[s][0], sizes[s][1], speeds[c][0], speeds[c][1], 1 + level % 3, TEST_SEED + level);
+                for (int frog_speed = 1; frog_speed <= 10; frog_speed += 3) {
+                    long long tick = level * 37;
+                    bool expected = plainSolvable(&board, frog_speed, tick);
+                    bool got = levelSolvable(&board, frog_speed, tick);
+                    if (got != expected) {
+                        fail("levelSolvable of a level", expected, got);
+                    }
+                    if (expected) {
+                        solvable++;
+                    }
+                    else {
+                        unsolvable++;
+                    }
+                }
+                freeArena(&board.arena);
+            }
+        }
+    }
+    if (solvable == 0 || unsolvable == 0) { // both answers have to be checked
+        fail("levels that can be won", 1, solvable);
+        fail("levels that can't be won", 1, unsolvable);
+    }
+    printf("%d levels can be won, %d can't\n", solvable, unsolvable);
+}
+
+//******************
+//* RANDOM NUMBERS *
+//******************
+
+// Function to compare two numbers for qsort
+int compareNumbers(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return x < y ? -1 : x > y ? 1 : 0;
+}
+
+// Function to check if two boards have the same level: the same obstacles and the same cars in the same slots
+bool sameLevel(const Board* a, const Board* b) {
+    if (a->rows != b->rows || a->cols != b->cols || a->num_roads != b->num_roads || a->cars.count != b->cars.count) {
+        return false;
+    }
+    for (int x = 0; x < a->rows; x++) {
+        for (int y = 0; y < a->cols; y++) {
+            if (isObstacle(a, x, y) != isObstacle(b, x, y)) {
+                return false;
+            }
+        }
+    }
+    for (int i = 0; i < a->cars.count; i++) {
+        if (a->cars.active[i] != b->cars.active[i]) {
+            return false;
+        }
+        if (a->cars.active[i] && (a->cars.x[i] != b->cars.x[i] || a->cars.y[i] != b->cars.y[i]
+            || a->cars.direction[i] != b->cars.direction[i] || a->cars.speed[i] != b->cars.speed[i]
+            || a->cars.next_move[i] != b->cars.next_move[i] || a->cars.symbol[i] != b->cars.symbol[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The streams of close seeds don't overlap and have no bits stuck, a stream started again gives the same
+// numbers as randomAt, randomInt stays below n and hits every value as often, and a level is the same
+// whatever was drawn before it
+void testRandomStreams() {
+    const int seeds = 20;
+    const int streams = RANDOM_SPAWN_STREAM + 1;
+    const int length = 1000;
+    int total = seeds * streams * length;
+    uint64_t* numbers = new uint64_t[total];
+    int ones[64] = { 0 };
+    Board board;
+    int count = 0;
+    for (int seed = 0; seed < seeds; seed++) {
+        seedRandom(&board, TEST_SEED + seed);
+        for (int stream = 0; stream < streams; stream++) {
+            uint64_t key = streamKey(TEST_SEED + seed, stream);
+            for (int n = 0; n < length; n++) {
+                numbers[count] = randomAt(key, n);
+                for (int bit = 0; bit < 64; bit++) {
+                    ones[bit] += int(numbers[count] >> bit & 1);
+                }
+                count++;
+            }
+            for (int again = 0; again < 2; again++) { // the stream from its first number, twice
+                startRandomStream(&board, stream);
+                for (int n = 0; n < length; n++) {
+                    int expected = int(((randomAt(key, n) >> 32) * 1000ULL) >> 32);
+                    int got = randomInt(&board, 1000);
+                    if (got != expected) {
+                        fail("number of a stream started again", expected, got);
+                    }
+                }
+            }
+        }
+    }
+    qsort(numbers, total, sizeof(uint64_t), compareNumbers);
+    for (int i = 1; i < total; i++) {
+        if (numbers[i] == numbers[i - 1]) { // a stream that is another one moved by a few numbers repeats them
+            fail("numbers that are in two streams", 0, (long long)numbers[i]);
+        }
+    }
+    for (int bit = 0; bit < 64; bit++) {
+        if (ones[bit] < total / 2 - total / 50 || ones[bit] > total / 2 + total / 50) {
+            fail("ones in a bit of the numbers", total / 2, ones[bit]);
+        }
+    }
+    delete[] numbers;
+
+    const int ranges[] = { 1, 2, 3, 7, 100 };
+    const int draws = 1000000;
+    for (int r = 0; r < 5; r++) {
+        int n = ranges[r];
+        int* hits = new int[n];
+        memset(hits, 0, n * sizeof(int));
+        seedRandom(&board, TEST_SEED + r);
+        for (int i = 0; i < draws; i++) {
+            int value = randomInt(&board, n);
+            if (value < 0 || value >= n) {
+                fail("random number below n", n - 1, value);
+                continue;
+            }
+            hits[value]++;
+        }
+        for (int value = 0; value < n; value++) {
+            if (hits[value] < draws / n * 95 / 100 || hits[value] > draws / n * 105 / 100) { // more than 5 deviations
+                fail("times a random number came", draws / n, hits[value]);
+            }
+        }
+        delete[] hits;
+    }
+
+    GameConfig config;
+    config.frog_speed = 5;
+    config.car_min_speed = 1;
+    config.car_max_speed = 5;
+    config.rows = 26;
+    config.cols = 70;
+    config.tick_rate = DEFAULT_TICK_RATE;
+    config.cars_per_road = 2;
+    config.background_levels = false;
+    for (int seed = 0; seed < 5; seed++) {
+        config.seed = TEST_SEED + seed;
+        Board alone;
+        Board after;
+        initArena(&alone.arena, boardMemorySize(config.rows, config.cols, config.cars_per_road));
+        initArena(&after.arena, boardMemorySize(config.rows, config.cols, config.cars_per_road));
+        for (int level = 1; level <= 4; level++) {
+            generateLevel(&after, &config, level);
+            for (int i = 0; i < level * 10; i++) { // the play draws its own numbers before the next level
+                randomInt(&after, 100);
+            }
+        }
+        for (int level = 4; level >= 1; level--) {
+            generateLevel(&alone, &config, level);
+            if (level == 4 && !sameLevel(&alone, &after)) {
+                fail("level made after the other ones", 1, 0);
+            }
+        }
+        generateLevel(&after, &config, 1); // the arena of a board is used again for every level
+        if (!sameLevel(&alone, &after)) {
+            fail("level made after a later one", 1, 0);
+        }
+        freeArena(&alone.arena);
+        freeArena(&after.arena);
+    }
+}
+
+//*************
+//* REWINDING *
+//*************
+
+#define TEST_MAX_WORDS 1000
+
+// Function to make a new image from the previous one: 0 - no change, 1 - every word, 2 - the first and the
+// last word, 3 - runs with gaps of one and two words, 4 - a few words anywhere
+void changeImage(const uint64_t* previous, uint64_t* image, int words, int kind) {
+    for (int i = 0; i < words; i++) {
+        bool changed = kind == 1 || (kind == 2 && (i == 0 || i == words - 1)) || (kind == 3 && i % 7 < 4 && i % 7 != 2)
+            || (kind == 4 && testRandom(10) == 0);
+        image[i] = changed ? previous[i] ^ (1ULL + (uint64_t)testRandom(1 << 30)) : previous[i];
+    }
+}
+
+// Function to hash what the player can see of a game and what decides its next steps
+uint64_t hashGame(const Game* game) {
+    const Board* board = game->board;
+    uint64_t hash = randomAt((uint64_t)game->tick, game->status);
+    for (int i = 0; i < board->cars.count; i++) {
+        if (board->cars.active[i]) {
+            hash = randomAt(hash, ((uint64_t)i << 48) ^ ((uint64_t)board->cars.x[i] << 32) ^ ((uint64_t)board->cars.y[i] << 16)
+                ^ (uint64_t)board->cars.next_move[i] ^ ((uint64_t)board->cars.speed[i] << 40));
+        }
+    }
+    hash = randomAt(hash, ((uint64_t)game->frog->x << 48) ^ ((uint64_t)game->frog->y << 32) ^ ((uint64_t)game->stork->x << 16)
+        ^ (uint64_t)game->stork->y);
+    hash = randomAt(hash, board->random.counter ^ ((uint64_t)board->friendly_on << 40));
+    return randomAt(hash, (uint64_t)CalculatePoints(game->frog, game->timer));
+}
+
+// encodeDelta and applyDelta take an image back and forth for changes of every kind and length, a delta that
+// doesn't fit writes nothing past its room, and a game that is rewound is in the state it had in that step
+void testRewind() {
+    const int sizes[] = { 1, 2, 3, 8, 64, TEST_MAX_WORDS };
+    uint64_t previous[TEST_MAX_WORDS];
+    uint64_t image[TEST_MAX_WORDS];
+    uint64_t copy[TEST_MAX_WORDS];
+    uint64_t delta[2 * TEST_MAX_WORDS + 1];
+    for (int s = 0; s < 6; s++) {
+        int words = sizes[s];
+        for (int kind = 0; kind < 5; kind++) {
+            for (int i = 0; i < words; i++) {
+                previous[i] = ((uint64_t)testRandom(1 << 30) << 32) | (uint64_t)testRandom(1 << 30);
+            }
+            changeImage(previous, image, words, kind);
+            size_t length = encodeDelta(image, previous, words, delta, 2 * words + 1);
+            if (kind == 0 && length != 0) {
+                fail("length of a delta without changes", 0, length);
+            }
+            memcpy(copy, previous, words * sizeof(uint64_t));
+            applyDelta(copy, delta, length);
+            if (memcmp(copy, image, words * sizeof(uint64_t)) != 0) {
+                fail("image made from a delta", words, kind);
+            }
+            for (size_t room = 0; room <= length + 1; room++) {
+                for (size_t i = 0; i <= length + 1; i++) {
+                    delta[i] = 0xDEADBEEFULL;
+                }
+                size_t got = encodeDelta(image, previous, words, delta, room);
+                size_t expected = length < room ? length : room; // a delta as long as the room doesn't fit either
+                if (got != expected) {
+                    fail("length of a delta with little room", expected, got);
+                }
+                for (size_t i = room; i <= length + 1; i++) {
+                    if (delta[i] != 0xDEADBEEFULL) {
+                        fail("word written past the room of a delta", room, i);
+                    }
+                }
+            }
+        }
+    }
+
+    GameConfig config;
+    config.frog_speed = 5;
+    config.car_min_speed = 1;
+    config.car_max_speed = 5;
+    config.rows = 26;
+    config.cols = 50;
+    config.tick_rate = DEFAULT_TICK_RATE;
+    config.background_levels = false;
+    const int max_ticks = 20000;
+    uint64_t* hashes = new uint64_t[max_ticks + 1];
+    int rewinds = 0;
+    for (int seed = 0; seed < 30; seed++) {
+        config.seed = TEST_SEED + seed;
+        config.cars_per_road = 1 + seed % 3;
+        Game game;
+        initGame(&game, &config);
+        RewindBuffer rewind;
+        initRewind(&rewind, seed % 2 == 0 ? REWIND_MEMORY : 100000, REWIND_MAX_SNAPSHOTS); // a small one drops snapshots
+        saveSnapshot(&rewind, &game);
+        hashes[0] = hashGame(&game);
+        while (game.status == GAME_RUNNING && game.tick < max_ticks) {
+            int input = testRandom(30);
+            step(&game, input <= INPUT_FRIENDLY ? input : INPUT_NONE);
+            saveSnapshot(&rewind, &game);
+            hashes[game.tick] = hashGame(&game);
+            if (testRandom(100) == 0) { // the game goes back 50 steps in 100 on the average, so it still gets on
+                long long steps = testRandom(100);
+                long long back = rewindGame(&rewind, &game, steps);
+                if (back < 0 || back > steps) {
+                    fail("steps gone back", steps, back);
+                }
+                if (back > 0 && hashGame(&game) != hashes[game.tick]) {
+                    fail("state of a rewound game in its step", 0, game.tick);
+                }
+                rewinds++;
+            }
+        }
+        freeRewind(&rewind);
+        freeGame(&game);
+    }
+    delete[] hashes;
+    printf("%d rewinds\n", rewinds);
+}
+
+//********
+//* KEYS *
+//********
+
+#define TEST_KEY_EVENTS 1000000
+
+struct KeyCase { // Bytes from the terminal and the keys they are, 0 ends the keys
+    const char* bytes;
+    int keys[4];
+};
+
+const KeyCase KEY_CASES[] = {
+    { "q", { 'q', 0 } },
+    { " r", { ' ', 'r', 0 } },
+    { "\x1b[A", { KEYBOARD_UP, 0 } },
+    { "\x1b[B\x1b[D\x1b[C", { KEYBOARD_DOWN, KEYBOARD_LEFT, KEYBOARD_RIGHT, 0 } },
+    { "\x1bOA\x1bOB", { KEYBOARD_UP, KEYBOARD_DOWN, 0 } }, // the arrows of a terminal in application mode
+    { "a\x1b[Ab", { 'a', KEYBOARD_UP, 'b', 0 } },
+    { "\x1bq", { 'q', 0 } }, // Esc and then q
+    { "\x1b\x1b[A", { KEYBOARD_UP, 0 } },
+    { "\x1bOPx\x1b[Zy", { 'x', 'y', 0 } }, // F1 and Shift+Tab aren't keys of the game
+    { "\x1b[", { 0 } }, // the rest of it comes in the next read
+};
+
+// Function to take the keys of the queue from another thread, they have to come in the order they were put in
+void takeKeys(KeyQueue* queue, int* wrong) {
+    KeyEvent event;
+    KeyEvent peeked;
+    for (int i = 0; i < TEST_KEY_EVENTS;) {
+        if (!peekKey(queue, &peeked)) {
+            std::this_thread::yield();
+            continue;
+        }
+        if (!popKey(queue, &event) || event.key != i || peeked.key != i || event.time != double(i)) {
+            (*wrong)++;
+        }
+        i++;
+    }
+}
+
+// The escape sequences of the arrows are decoded whichever way the bytes come, the bytes after an unfinished
+// sequence go on with it, and the ring of keys keeps every key in its order, full or empty, between two threads
+void testKeyboard() {
+    KeyboardReader reader; // on the stack, new doesn't keep the alignment of the counters in C++11
+    KeyboardReader* keyboard = &reader;
+    keyboard->escape = 0;
+    int cases = sizeof(KEY_CASES) / sizeof(KEY_CASES[0]);
+    for (int c = 0; c < cases; c++) {
+        int next = 0;
+        for (const char* byte = KEY_CASES[c].bytes; *byte != 0; byte++) { // one byte at a time, as in any split read
+            int key = decodeByte(keyboard, (unsigned char)*byte);
+            if (key == 0) {
+                continue;
+            }
+            if (next >= 3 || key != KEY_CASES[c].keys[next]) {
+                fail("key of the bytes", c, key);
+            }
+            next++;
+        }
+        if (KEY_CASES[c].keys[next] != 0) {
+            fail("keys of the bytes", KEY_CASES[c].keys[next], 0);
+        }
+    }
+    if (decodeByte(keyboard, 'A') != KEYBOARD_UP) { // the end of the last one
+        fail("key after an unfinished sequence", KEYBOARD_UP, 0);
+    }
+    decodeByte(keyboard, 0x1B);
+    decodeByte(keyboard, 'O');
+    if (decodeByte(keyboard, 'D') != KEYBOARD_LEFT) {
+        fail("key of a sequence in three reads", KEYBOARD_LEFT, 0);
+    }
+
+    KeyQueue* queue = &keyboard->queue;
+    KeyEvent event;
+    initKeyQueue(queue);
+    if (peekKey(queue, &event) || popKey(queue, &event)) {
+        fail("key of an empty queue", 0, 1);
+    }
+    for (int round = 0; round < 3; round++) { // the counters go past the end of the ring
+        for (int i = 0; i < KEY_QUEUE_SIZE; i++) {
+            event.key = i;
+            event.time = 0.0;
+            if (!pushKey(queue, &event)) {
+                fail("key added to a queue with room", i, 0);
+            }
+        }
+        event.key = KEY_QUEUE_SIZE;
+        if (pushKey(queue, &event)) {
+            fail("key added to a full queue", 0, 1);
+        }
+        for (int i = 0; i < KEY_QUEUE_SIZE / 2; i++) {
+            if (!popKey(queue, &event) || event.key != i) {
+                fail("key taken from the queue", i, event.key);
+            }
+        }
+        clearKeys(queue);
+        if (popKey(queue, &event)) {
+            fail("key of a cleared queue", 0, event.key);
+        }
+    }
+
+    int wrong = 0;
+    std::thread taker(takeKeys, queue, &wrong);
+    for (int i = 0; i < TEST_KEY_EVENTS;) {
+        event.key = i;
+        event.time = double(i);
+        if (pushKey(queue, &event)) {
+            i++;
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+    taker.join();
+    if (wrong != 0) {
+        fail("keys taken out of order on another thread", 0, wrong);
+    }
+}
+
+//*****************
+//* MAIN FUNCTION *
+//*****************
+
+struct Test {
+    const char* name;
+    void (*run)();
+};
+
+const Test TESTS[] = {
+    { "field", testField },
+    { "solver", testSolver },
+    { "random", testRandomStreams },
+    { "rewind", testRewind },
+    { "keyboard", testKeyboard },
+};
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        printf("Usage: frog-tests NAME\n");
+        return 1;
+    }
+    for (size_t i = 0; i < sizeof(TESTS) / sizeof(TESTS[0]); i++) {
+        if (strcmp(argv[1], TESTS[i].name) == 0) {
+            TESTS[i].run();
+            if (failures > 0) {
+                printf("%s: %d checks failed\n", TESTS[i].name, failures);
+                return 1;
+            }
+            printf("%s: OK\n", TESTS[i].name);
+            return 0;
+        }
+    }
+    printf("Unknown test: %s\n", argv[1]);
+    return 1;
+}